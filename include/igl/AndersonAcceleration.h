@@ -0,0 +1,125 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_ANDERSON_ACCELERATION_H
+#define IGL_ANDERSON_ACCELERATION_H
+#include <Eigen/Core>
+#include <Eigen/QR>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace igl
+{
+  // Anderson acceleration [Walker & Ni 2011] of a fixed-point iteration
+  // x_{k+1} = G(x_k), such as the local/global iterations of ARAP, SLIM or
+  // ShapeUp [Peng et al. 2018]. The next iterate is the combination of the
+  // last m+1 values of G minimizing the (linearized) fixed-point residual
+  // G(x)-x, found by a small least squares problem over a sliding window of
+  // residual differences.
+  //
+  // Accelerated iterates may increase the energy the plain iteration
+  // decreases, so callers should check them (e.g., energy did not increase,
+  // no flipped elements) and call `restart` with the plain iterate G(x_k) if
+  // they are rejected.
+  //
+  // Example:
+  //   AndersonAcceleration<double> aa(5,x);
+  //   while(...)
+  //   {
+  //     const VectorXd g = G(x);
+  //     x = aa.compute(g);
+  //     if(!acceptable(x)) { x = g; aa.restart(g); }
+  //   }
+  template <typename Scalar>
+  class AndersonAcceleration
+  {
+  public:
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixXS;
+    // Inputs:
+    //   m  window size (number of previous iterates combined)
+    //   x0  initial iterate
+    AndersonAcceleration(const int m, const VectorXS & x0)
+    {
+      init(m,x0);
+    }
+    AndersonAcceleration():m_m(0),m_iter(0),m_col(0),m_residual(0){}
+    void init(const int m, const VectorXS & x0)
+    {
+      m_m = m;
+      m_x = x0;
+      m_dG.resize(x0.size(),m);
+      m_dF.resize(x0.size(),m);
+      m_iter = 0;
+      m_col = 0;
+      m_residual = 0;
+    }
+    // Inputs:
+    //   g  G(x) where x is the last iterate returned (or x0)
+    // Returns next iterate
+    const VectorXS & compute(const VectorXS & g)
+    {
+      assert(g.size() == m_x.size());
+      const VectorXS f = g - m_x;
+      m_residual = f.norm();
+      if(m_iter == 0 || m_m <= 0)
+      {
+        m_prev_f = f;
+        m_prev_g = g;
+        m_x = g;
+        m_iter++;
+        return m_x;
+      }
+      // Newest differences, normalized for conditioning
+      m_dF.col(m_col) = f - m_prev_f;
+      m_dG.col(m_col) = g - m_prev_g;
+      const Scalar scale = m_dF.col(m_col).norm();
+      m_prev_f = f;
+      m_prev_g = g;
+      if(scale > 0 && std::isfinite(scale))
+      {
+        m_dF.col(m_col) /= scale;
+        m_dG.col(m_col) /= scale;
+        m_col = (m_col+1)%m_m;
+        m_iter++;
+      }
+      const int k = std::min(m_iter-1,m_m);
+      if(k == 0)
+      {
+        m_x = g;
+        return m_x;
+      }
+      // θ = argmin ‖f - dF θ‖, x = g - dG θ
+      const VectorXS theta = m_dF.leftCols(k).colPivHouseholderQr().solve(f);
+      if(!theta.allFinite())
+      {
+        restart(g);
+        return m_x;
+      }
+      m_x = g - m_dG.leftCols(k)*theta;
+      return m_x;
+    }
+    // Forget the history and continue from x (e.g., the plain iterate after
+    // rejecting an accelerated one)
+    void restart(const VectorXS & x)
+    {
+      m_x = x;
+      m_iter = 0;
+      m_col = 0;
+    }
+    // Norm of the fixed-point residual G(x)-x at the last call to compute
+    Scalar residual() const { return m_residual; }
+  private:
+    int m_m,m_iter,m_col;
+    Scalar m_residual;
+    VectorXS m_x,m_prev_f,m_prev_g;
+    MatrixXS m_dG,m_dF;
+  };
+}
+
+#endif
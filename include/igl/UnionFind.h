@@ -0,0 +1,124 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_UNION_FIND_H
+#define IGL_UNION_FIND_H
+#include "parallel_for.h"
+#include <Eigen/Core>
+#include <atomic>
+#include <memory>
+
+namespace igl
+{
+  // Lock-free disjoint-set forest for (concurrent) connected component
+  // labeling. `find` and `unite` may be called from many threads at once
+  // (e.g., inside igl::parallel_for). Each set is always rooted at its
+  // smallest element (link by index, find with path halving via
+  // compare-and-swap), so the resulting labels do not depend on the order in
+  // which unions were performed.
+  //
+  // Example:
+  //   UnionFind uf(n);
+  //   parallel_for(E.rows(),[&](const int e){ uf.unite(E(e,0),E(e,1)); },1000);
+  //   uf.labels(C,counts);
+  class UnionFind
+  {
+  public:
+    // Inputs:
+    //   n  number of elements, each starting in its own set
+    UnionFind(const int n):
+      m_n(n),
+      m_parent(new std::atomic<int>[n])
+    {
+      std::atomic<int> * parent = m_parent.get();
+      parallel_for(n,[parent](const int i){ parent[i].store(i); },10000);
+    }
+    // Returns the root (smallest element) of the set containing a
+    inline int find(int a) const
+    {
+      while(true)
+      {
+        int p = m_parent[a].load();
+        if(p == a)
+        {
+          return a;
+        }
+        const int gp = m_parent[p].load();
+        if(gp != p)
+        {
+          // Halve the path. Failure means someone else already moved a's
+          // parent further up, which is just as good.
+          m_parent[a].compare_exchange_weak(p,gp);
+        }
+        a = gp;
+      }
+    }
+    // Merge the sets containing a and b
+    inline void unite(int a, int b) const
+    {
+      while(true)
+      {
+        a = find(a);
+        b = find(b);
+        if(a == b)
+        {
+          return;
+        }
+        // Always hang the larger root below the smaller one
+        if(a < b)
+        {
+          std::swap(a,b);
+        }
+        int expected = a;
+        if(m_parent[a].compare_exchange_strong(expected,b))
+        {
+          return;
+        }
+        // a stopped being a root in the meantime: try again
+      }
+    }
+    // Label each element by its set. Must not be called concurrently with
+    // unite.
+    //
+    // Outputs:
+    //   C  n list of set ids (starting with 0), numbered in order of the
+    //     smallest element of each set
+    //   counts  #sets list of number of elements in each set
+    template <typename DerivedC, typename Derivedcounts>
+    inline void labels(
+      Eigen::PlainObjectBase<DerivedC> & C,
+      Eigen::PlainObjectBase<Derivedcounts> & counts) const
+    {
+      const int n = m_n;
+      C.resize(n,1);
+      parallel_for(n,[this,&C](const int i){ C(i,0) = find(i); },10000);
+      // Roots precede all other members of their set, so a single ordered
+      // pass relabels roots to consecutive ids and members by their root.
+      typename DerivedC::Scalar num_sets = 0;
+      for(int i = 0;i<n;i++)
+      {
+        C(i,0) = C(i,0) == i ? num_sets++ : C(C(i,0),0);
+      }
+      counts.setZero(num_sets,1);
+      for(int i = 0;i<n;i++)
+      {
+        counts(C(i,0))++;
+      }
+    }
+    template <typename DerivedC>
+    inline void labels(Eigen::PlainObjectBase<DerivedC> & C) const
+    {
+      Eigen::VectorXi counts;
+      labels(C,counts);
+    }
+  private:
+    int m_n;
+    std::unique_ptr<std::atomic<int>[]> m_parent;
+  };
+}
+
+#endif
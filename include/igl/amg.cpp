@@ -0,0 +1,344 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "amg.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+namespace igl
+{
+  // Number of rows below which sparse matrix-vector products run serially
+  const int AMG_MIN_PARALLEL = 10000;
+  // y = b - A*x, parallel over rows
+  template <typename Scalar>
+  IGL_INLINE void amg_residual(
+    const Eigen::SparseMatrix<Scalar,Eigen::RowMajor> & A,
+    const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & b,
+    const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & x,
+    Eigen::Matrix<Scalar,Eigen::Dynamic,1> & y)
+  {
+    typedef typename Eigen::SparseMatrix<Scalar,Eigen::RowMajor>::InnerIterator
+      Iterator;
+    y.resize(A.rows());
+    parallel_for(A.rows(),[&](const int i)
+    {
+      Scalar yi = b.size() == 0 ? 0 : b(i);
+      for(Iterator it(A,i);it;++it)
+      {
+        yi -= it.value()*x(it.col());
+      }
+      y(i) = yi;
+    },AMG_MIN_PARALLEL);
+  }
+  // y = A*x, parallel over rows
+  template <typename Scalar>
+  IGL_INLINE void amg_multiply(
+    const Eigen::SparseMatrix<Scalar,Eigen::RowMajor> & A,
+    const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & x,
+    Eigen::Matrix<Scalar,Eigen::Dynamic,1> & y)
+  {
+    typedef typename Eigen::SparseMatrix<Scalar,Eigen::RowMajor>::InnerIterator
+      Iterator;
+    y.resize(A.rows());
+    parallel_for(A.rows(),[&](const int i)
+    {
+      Scalar yi = 0;
+      for(Iterator it(A,i);it;++it)
+      {
+        yi += it.value()*x(it.col());
+      }
+      y(i) = yi;
+    },AMG_MIN_PARALLEL);
+  }
+  // One V-cycle on level l approximately solving A[l] x = b, starting from x
+  template <typename Scalar>
+  IGL_INLINE void amg_vcycle(
+    const AMGData<Scalar> & data,
+    const int l,
+    const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & b,
+    Eigen::Matrix<Scalar,Eigen::Dynamic,1> & x)
+  {
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+    if(l+1 == (int)data.A.size())
+    {
+      x = data.coarse.solve(b);
+      return;
+    }
+    const auto & A = data.A[l];
+    const auto & Dinv = data.Dinv[l];
+    VectorXS r;
+    const auto smooth = [&]()
+    {
+      for(int s = 0;s<data.smoothing_steps;s++)
+      {
+        amg_residual(A,b,x,r);
+        x += Dinv.cwiseProduct(r);
+      }
+    };
+    smooth();
+    amg_residual(A,b,x,r);
+    VectorXS bc,xc,e;
+    amg_multiply(data.R[l],r,bc);
+    xc.setZero(bc.size());
+    amg_vcycle(data,l+1,bc,xc);
+    amg_multiply(data.P[l],xc,e);
+    x += e;
+    smooth();
+  }
+}
+
+template <typename Scalar>
+IGL_INLINE bool igl::amg_precompute(
+  const Eigen::SparseMatrix<Scalar> & A0,
+  AMGData<Scalar> & data)
+{
+  typedef Eigen::SparseMatrix<Scalar,Eigen::RowMajor> RowMatrix;
+  typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+  typedef typename RowMatrix::InnerIterator Iterator;
+  assert(A0.rows() == A0.cols() && "A should be square");
+  data.A.clear();
+  data.P.clear();
+  data.R.clear();
+  data.Dinv.clear();
+  data.A.push_back(RowMatrix(A0));
+  while(true)
+  {
+    const RowMatrix & A = data.A.back();
+    const int n = A.rows();
+    if(n <= data.max_coarse_size || (int)data.A.size() >= data.max_levels)
+    {
+      break;
+    }
+    const VectorXS D = A.diagonal();
+    if(!(D.array() > 0).all())
+    {
+      std::cerr<<"Error: amg_precompute: non-positive diagonal entry"<<std::endl;
+      return false;
+    }
+    const auto strong = [&](const int i, Iterator & it)->bool
+    {
+      const int j = it.col();
+      return j != i &&
+        std::abs(it.value()) >=
+          data.strength_threshold*std::sqrt(std::abs(D(i)*D(j)));
+    };
+
+    // Greedy aggregation along strong connections
+    std::vector<int> agg(n,-1);
+    int na = 0;
+    // 1. Seed aggregates at vertices whose strong neighborhood is free
+    for(int i = 0;i<n;i++)
+    {
+      if(agg[i] >= 0)
+      {
+        continue;
+      }
+      bool free = true;
+      for(Iterator it(A,i);it && free;++it)
+      {
+        free = !strong(i,it) || agg[it.col()] < 0;
+      }
+      if(free)
+      {
+        agg[i] = na;
+        for(Iterator it(A,i);it;++it)
+        {
+          if(strong(i,it))
+          {
+            agg[it.col()] = na;
+          }
+        }
+        na++;
+      }
+    }
+    // 2. Attach leftovers to the most strongly connected seeded aggregate
+    std::vector<int> seeded = agg;
+    for(int i = 0;i<n;i++)
+    {
+      if(seeded[i] >= 0)
+      {
+        continue;
+      }
+      Scalar best = 0;
+      for(Iterator it(A,i);it;++it)
+      {
+        if(strong(i,it) && seeded[it.col()] >= 0 && std::abs(it.value()) > best)
+        {
+          best = std::abs(it.value());
+          agg[i] = seeded[it.col()];
+        }
+      }
+    }
+    // 3. Group whatever is left with its free neighbors
+    for(int i = 0;i<n;i++)
+    {
+      if(agg[i] >= 0)
+      {
+        continue;
+      }
+      agg[i] = na;
+      for(Iterator it(A,i);it;++it)
+      {
+        if(strong(i,it) && agg[it.col()] < 0)
+        {
+          agg[it.col()] = na;
+        }
+      }
+      na++;
+    }
+    if(na == n)
+    {
+      // No coarsening possible
+      break;
+    }
+
+    // Tentative prolongation: normalized indicator functions of aggregates
+    // (interpolating the constant near-null space)
+    std::vector<int> count(na,0);
+    for(int i = 0;i<n;i++)
+    {
+      count[agg[i]]++;
+    }
+    RowMatrix T(n,na);
+    {
+      std::vector<Eigen::Triplet<Scalar> > IJV;
+      IJV.reserve(n);
+      for(int i = 0;i<n;i++)
+      {
+        IJV.emplace_back(i,agg[i],1./std::sqrt(Scalar(count[agg[i]])));
+      }
+      T.setFromTriplets(IJV.begin(),IJV.end());
+    }
+
+    // Estimate spectral radius of D⁻¹A by power iteration
+    VectorXS Dinv = D.cwiseInverse();
+    Scalar rho = 0;
+    {
+      VectorXS x(n),y;
+      for(int i = 0;i<n;i++)
+      {
+        x(i) = 1 + Scalar(i%7)/7.;
+      }
+      x.normalize();
+      for(int k = 0;k<20;k++)
+      {
+        amg_multiply(A,x,y);
+        y = Dinv.cwiseProduct(y);
+        rho = y.norm();
+        if(rho == 0)
+        {
+          break;
+        }
+        x = y/rho;
+      }
+    }
+    // Damping weight used both for smoothing the prolongation and for Jacobi
+    // relaxation
+    const Scalar omega = (rho > 0 ? 4./(3.*rho) : 2./3.);
+    Dinv *= omega;
+
+    // Smoothed prolongation P = (I - ω D⁻¹A) T
+    RowMatrix AT = A*T;
+    RowMatrix P = T - RowMatrix(Dinv.asDiagonal()*AT);
+    P.prune(Scalar(0));
+    RowMatrix R = P.transpose();
+    // Galerkin coarse operator
+    RowMatrix Ac = R*(A*P);
+    Ac.prune(Scalar(0));
+    data.Dinv.push_back(Dinv);
+    data.P.push_back(P);
+    data.R.push_back(R);
+    data.A.push_back(Ac);
+  }
+
+  data.coarse.compute(Eigen::SparseMatrix<Scalar>(data.A.back()));
+  if(data.coarse.info() != Eigen::Success)
+  {
+    std::cerr<<"Error: amg_precompute: coarse factorization failed"<<std::endl;
+    return false;
+  }
+  return true;
+}
+
+template <typename Scalar, typename DerivedB, typename DerivedX>
+IGL_INLINE bool igl::amg_solve(
+  const AMGData<Scalar> & data,
+  const Eigen::MatrixBase<DerivedB> & B,
+  Eigen::PlainObjectBase<DerivedX> & X)
+{
+  typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+  assert(data.A.size() > 0 && "Call amg_precompute first");
+  const auto & A = data.A[0];
+  const int n = A.rows();
+  assert(B.rows() == n);
+  if(X.rows() != n || X.cols() != B.cols())
+  {
+    X.setZero(n,B.cols());
+  }
+  bool converged = true;
+  for(int c = 0;c<B.cols();c++)
+  {
+    const VectorXS b = B.col(c).template cast<Scalar>();
+    VectorXS x = X.col(c).template cast<Scalar>();
+    const Scalar bnorm = b.norm();
+    if(bnorm == 0)
+    {
+      X.col(c).setZero();
+      continue;
+    }
+    VectorXS r;
+    amg_residual(A,b,x,r);
+    Scalar rnorm = r.norm();
+    if(data.pcg)
+    {
+      // Conjugate gradient preconditioned by one V-cycle
+      VectorXS z = VectorXS::Zero(n),p,Ap;
+      amg_vcycle(data,0,r,z);
+      p = z;
+      Scalar rz = r.dot(z);
+      for(int k = 0;k<data.max_iter && rnorm > data.tolerance*bnorm;k++)
+      {
+        amg_multiply(A,p,Ap);
+        const Scalar alpha = rz/p.dot(Ap);
+        x += alpha*p;
+        r -= alpha*Ap;
+        rnorm = r.norm();
+        if(rnorm <= data.tolerance*bnorm)
+        {
+          break;
+        }
+        z.setZero();
+        amg_vcycle(data,0,r,z);
+        const Scalar rz_new = r.dot(z);
+        p = z + (rz_new/rz)*p;
+        rz = rz_new;
+      }
+    }else
+    {
+      // Stationary V-cycle iteration
+      for(int k = 0;k<data.max_iter && rnorm > data.tolerance*bnorm;k++)
+      {
+        amg_vcycle(data,0,b,x);
+        amg_residual(A,b,x,r);
+        rnorm = r.norm();
+      }
+    }
+    converged = converged && rnorm <= data.tolerance*bnorm;
+    X.col(c) = x.template cast<typename DerivedX::Scalar>();
+  }
+  return converged;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::amg_precompute<double>(Eigen::SparseMatrix<double, 0, int> const&, igl::AMGData<double>&);
+template bool igl::amg_solve<double, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(igl::AMGData<double> const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+template bool igl::amg_solve<double, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(igl::AMGData<double> const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
+#endif
@@ -0,0 +1,92 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_AMG_H
+#define IGL_AMG_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <vector>
+
+namespace igl
+{
+  template <typename Scalar>
+  struct AMGData
+  {
+    typedef Eigen::SparseMatrix<Scalar,Eigen::RowMajor> RowMatrix;
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+    // Parameters of the hierarchy (set before amg_precompute)
+    //
+    // Strength of connection threshold: A(i,j) is a strong connection if
+    // |A(i,j)| >= strength_threshold * sqrt(|A(i,i) A(j,j)|)
+    Scalar strength_threshold = 0.08;
+    // Stop coarsening once a level has at most this many unknowns
+    int max_coarse_size = 500;
+    int max_levels = 20;
+    // Parameters of amg_solve (may be changed after amg_precompute)
+    //
+    // Use the V-cycle as preconditioner for conjugate gradient (true) or as a
+    // standalone stationary solver (false)
+    bool pcg = true;
+    // Number of pre- and post-smoothing (damped Jacobi) sweeps per level
+    int smoothing_steps = 2;
+    // Relative residual tolerance and maximum number of iterations
+    Scalar tolerance = 1e-8;
+    int max_iter = 200;
+    // Hierarchy: A[l] is the operator on level l (A[0] the input matrix),
+    // P[l] prolongates from level l+1 to level l and R[l] = P[l]'
+    std::vector<RowMatrix> A,P,R;
+    // Jacobi weight times inverse diagonal of A[l]
+    std::vector<VectorXS> Dinv;
+    // Direct factorization of the coarsest level
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<Scalar> > coarse;
+  };
+  // AMG_PRECOMPUTE Build a smoothed aggregation algebraic multigrid hierarchy
+  // [Vanek et al. 1996] for a sparse symmetric positive definite matrix, e.g.,
+  // a (negated) cotangent Laplacian with fixed values or a mass-shifted
+  // Laplacian. Unlike a sparse Cholesky factorization, the hierarchy has no
+  // fill-in: its memory is O(#A) and solving with it costs O(#A) per
+  // iteration.
+  //
+  // Vertices are greedily aggregated along strong connections, the piecewise
+  // constant prolongation is smoothed by one damped Jacobi step and coarse
+  // operators are formed by Galerkin projection R*A*P.
+  //
+  // Inputs:
+  //   A  n by n sparse symmetric positive definite matrix
+  // Outputs:
+  //   data  multigrid hierarchy (see amg_solve)
+  // Returns true on success, false on error (e.g., non-positive diagonal)
+  template <typename Scalar>
+  IGL_INLINE bool amg_precompute(
+    const Eigen::SparseMatrix<Scalar> & A,
+    AMGData<Scalar> & data);
+  // AMG_SOLVE Solve A X = B using a hierarchy computed by amg_precompute.
+  // Matrix-vector products and smoothing are parallelized over rows; columns
+  // of B are solved one after another.
+  //
+  // Inputs:
+  //   data  multigrid hierarchy (see amg_precompute)
+  //   B  n by k right-hand side
+  //   X  if n by k, initial guess (e.g., previous solution), otherwise
+  //     ignored and zero is used
+  // Outputs:
+  //   X  n by k solution
+  // Returns true if all columns converged to data.tolerance within
+  // data.max_iter iterations
+  template <typename Scalar, typename DerivedB, typename DerivedX>
+  IGL_INLINE bool amg_solve(
+    const AMGData<Scalar> & data,
+    const Eigen::MatrixBase<DerivedB> & B,
+    Eigen::PlainObjectBase<DerivedX> & X);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "amg.cpp"
+#endif
+
+#endif
@@ -19,7 +19,13 @@
 #include "repdiag.h"
 #include "columnize.h"
 #include "fit_rotations.h"
+#include "decimate.h"
+#include "point_mesh_squared_distance.h"
+#include "barycentric_coordinates.h"
+#include "Timer.h"
+#include "AndersonAcceleration.h"
 #include <cassert>
+#include <limits>
 #include <iostream>
 
 template <
@@ -43,6 +49,8 @@ IGL_INLINE bool igl::arap_precomputation(
   assert((b.size() == 0 || b.minCoeff() >=0) && "b out of bounds");
   // remember b
   data.b = b;
+  // per vertex groups (data.G may be converted to per element groups below)
+  const VectorXi G_V = data.G;
   //assert(F.cols() == 3 && "For now only triangles");
   // dimension
   //const int dim = V.cols();
@@ -161,8 +169,142 @@ IGL_INLINE bool igl::arap_precomputation(
     data.vel = MatrixXd::Zero(n,data.dim);
   }
 
-  return min_quad_with_fixed_precompute(
-    Q,b,SparseMatrix<double>(),true,data.solver_data);
+  data.Q = Q;
+  if(!min_quad_with_fixed_precompute(
+    Q,b,SparseMatrix<double>(),true,data.solver_data))
+  {
+    return false;
+  }
+
+  // Multi-resolution hierarchy
+  data.coarse.clear();
+  data.coarse_U.clear();
+  data.coarse_bc.clear();
+  data.coarse_bc_offset.clear();
+  data.coarse_I.clear();
+  data.prolongation.clear();
+  data.prolongation_offset.clear();
+  if(data.levels > 0)
+  {
+    assert(F.cols() == 3 && V.cols() == 3 && data.dim == 3 &&
+      "Multi-resolution ARAP needs a 3D triangle mesh");
+    // Decimate: meshes[0] is this mesh, meshes.back() the coarsest
+    std::vector<MatrixXd> VL(1,V.template cast<double>());
+    std::vector<MatrixXi> FL(1,F.template cast<int>());
+    // Birth vertices in this mesh
+    std::vector<VectorXi> IL(1,VectorXi::LinSpaced(n,0,n-1));
+    for(int l = 0;l<data.levels;l++)
+    {
+      MatrixXd Vc;
+      MatrixXi Fc;
+      VectorXi J,I;
+      const size_t m = std::max<size_t>(4,FL.back().rows()*data.decimation_ratio);
+      decimate(VL.back(),FL.back(),m,Vc,Fc,J,I);
+      if(Fc.rows() >= FL.back().rows() || Fc.rows() == 0)
+      {
+        break;
+      }
+      VL.push_back(Vc);
+      FL.push_back(Fc);
+      VectorXi Ic;
+      slice(IL.back(),I,Ic);
+      IL.push_back(Ic);
+    }
+    const MatrixXd & Vb = VL[0];
+    for(int l = VL.size()-1;l>0;l--)
+    {
+      const MatrixXd & Vc = VL[l];
+      const MatrixXi & Fc = FL[l];
+      // Snap handles to their closest coarse vertex (several handles may
+      // share one, then their boundary conditions are averaged)
+      std::vector<int> bl;
+      std::vector<Triplet<double> > IJV;
+      {
+        std::vector<int> slot(Vc.rows(),-1);
+        std::vector<int> count;
+        for(int k = 0;k<b.size();k++)
+        {
+          int c;
+          (Vc.rowwise()-Vb.row(b(k))).rowwise().squaredNorm().minCoeff(&c);
+          if(slot[c] < 0)
+          {
+            slot[c] = bl.size();
+            bl.push_back(c);
+            count.push_back(0);
+          }
+          count[slot[c]]++;
+          IJV.emplace_back(slot[c],k,1.);
+        }
+        for(auto & t : IJV)
+        {
+          t = Triplet<double>(t.row(),t.col(),1./count[t.row()]);
+        }
+      }
+      SparseMatrix<double> Bl(bl.size(),b.size());
+      Bl.setFromTriplets(IJV.begin(),IJV.end());
+      MatrixXd Ol(bl.size(),Vc.cols());
+      {
+        MatrixXd Vbb;
+        slice(Vb,b,1,Vbb);
+        const MatrixXd BVbb = Bl*Vbb;
+        for(int s = 0;s<(int)bl.size();s++)
+        {
+          Ol.row(s) = Vc.row(bl[s]) - BVbb.row(s);
+        }
+      }
+      std::shared_ptr<ARAPData> coarse(new ARAPData());
+      coarse->energy = data.energy;
+      coarse->with_dynamics = data.with_dynamics;
+      coarse->h = data.h;
+      coarse->ym = data.ym;
+      coarse->max_iter = data.max_iter;
+      if(G_V.size() > 0)
+      {
+        slice(G_V,IL[l],coarse->G);
+      }
+      VectorXi blv = Map<VectorXi>(bl.data(),bl.size());
+      if(!arap_precomputation(Vc,Fc,data.dim,blv,*coarse))
+      {
+        return false;
+      }
+      // Barycentric prolongation onto the next finer level
+      const MatrixXd & Vf = VL[l-1];
+      VectorXd sqrD;
+      VectorXi I;
+      MatrixXd C,L;
+      point_mesh_squared_distance(Vf,Vc,Fc,sqrD,I,C);
+      MatrixXd A(Vf.rows(),3),B(Vf.rows(),3),CC(Vf.rows(),3);
+      for(int i = 0;i<Vf.rows();i++)
+      {
+        A.row(i) = Vc.row(Fc(I(i),0));
+        B.row(i) = Vc.row(Fc(I(i),1));
+        CC.row(i) = Vc.row(Fc(I(i),2));
+      }
+      barycentric_coordinates(C,A,B,CC,L);
+      std::vector<Triplet<double> > PIJV;
+      PIJV.reserve(3*Vf.rows());
+      for(int i = 0;i<Vf.rows();i++)
+      {
+        for(int c = 0;c<3;c++)
+        {
+          // Degenerate coarse triangles give NaN weights: fall back to the
+          // closest corner
+          const double w = L(i,c) == L(i,c) ? L(i,c) : (c == 0 ? 1. : 0.);
+          PIJV.emplace_back(i,Fc(I(i),c),w);
+        }
+      }
+      SparseMatrix<double> P(Vf.rows(),Vc.rows());
+      P.setFromTriplets(PIJV.begin(),PIJV.end());
+      data.coarse.push_back(coarse);
+      data.coarse_U.push_back(Vc);
+      data.coarse_bc.push_back(Bl);
+      data.coarse_bc_offset.push_back(Ol);
+      data.coarse_I.push_back(IL[l]);
+      data.prolongation.push_back(P);
+      data.prolongation_offset.push_back(Vf - P*Vc);
+    }
+  }
+  return true;
 }
 
 template <
@@ -182,6 +324,57 @@ IGL_INLINE bool igl::arap_solve(
   }
   const int n = data.n;
   int iter = 0;
+  int max_iter = data.max_iter;
+  const int L = data.coarse.size();
+  igl::Timer timer;
+  // doesn't change for fixed with_dynamics timestep
+  MatrixXd U0;
+  if(data.with_dynamics)
+  {
+    U0 = U;
+  }
+  if(L > 0)
+  {
+    // Multi-resolution: solve coarse to fine, prolongating each level's
+    // solution onto the next
+    data.level_times.assign(L+1,0);
+    const bool iters = (int)data.level_iters.size() == L+1;
+    for(int l = 0;l<L;l++)
+    {
+      timer.start();
+      if(iters)
+      {
+        data.coarse[l]->max_iter = data.level_iters[l];
+      }
+      data.coarse[l]->anderson_m = data.anderson_m;
+      if(data.with_dynamics)
+      {
+        slice(data.f_ext,data.coarse_I[l],1,data.coarse[l]->f_ext);
+      }
+      MatrixXd bcl;
+      if(bc.size() > 0)
+      {
+        bcl = data.coarse_bc[l]*bc.template cast<double>() +
+          data.coarse_bc_offset[l];
+      }
+      arap_solve(bcl,*data.coarse[l],data.coarse_U[l]);
+      const MatrixXd Uf =
+        data.prolongation[l]*data.coarse_U[l] + data.prolongation_offset[l];
+      if(l+1 < L)
+      {
+        data.coarse_U[l+1] = Uf;
+      }else
+      {
+        U = Uf.template cast<typename DerivedU::Scalar>();
+      }
+      data.level_times[l] += timer.getElapsedTimeInSec();
+    }
+    if(iters)
+    {
+      max_iter = data.level_iters[L];
+    }
+    timer.start();
+  }
   if(U.size() == 0)
   {
     // terrible initial guess.. should at least copy input mesh
@@ -195,23 +388,16 @@ IGL_INLINE bool igl::arap_solve(
   }
   // changes each arap iteration
   MatrixXd U_prev = U;
-  // doesn't change for fixed with_dynamics timestep
-  MatrixXd U0;
-  if(data.with_dynamics)
+  if(data.with_dynamics && U0.size() == 0)
   {
     U0 = U_prev;
   }
-  while(iter < data.max_iter)
+  // Local step: fit rotations to U and build the right-hand side of the
+  // global step, one column per dimension
+  const auto local_step = [&](const MatrixXd & X)->MatrixXd
   {
-    U_prev = U;
-    // enforce boundary conditions exactly
-    for(int bi = 0;bi<bc.rows();bi++)
-    {
-      U.row(data.b(bi)) = bc.row(bi);
-    }
-
-    const auto & Udim = U.replicate(data.dim,1);
-    assert(U.cols() == data.dim);
+    const auto & Udim = X.replicate(data.dim,1);
+    assert(X.cols() == data.dim);
     // As if U.col(2) was 0
     MatrixXd S = data.CSM * Udim;
     // THIS NORMALIZATION IS IMPORTANT TO GET SINGLE PRECISION SVD CODE TO WORK
@@ -276,32 +462,95 @@ IGL_INLINE bool igl::arap_solve(
     columnize(eff_R,num_rots,2,Rcol);
     VectorXd Bcol = -data.K * Rcol;
     assert(Bcol.size() == data.n*data.dim);
+    MatrixXd B(n,data.dim);
     for(int c = 0;c<data.dim;c++)
     {
-      VectorXd Uc,Bc,bcc,Beq;
-      Bc = Bcol.block(c*n,0,n,1);
+      B.col(c) = Bcol.block(c*n,0,n,1);
       if(data.with_dynamics)
       {
-        Bc += Dl.col(c);
+        B.col(c) += Dl.col(c);
       }
+    }
+    return B;
+  };
+  // Energy (up to a constant) minimized by the global step. With B from the
+  // local step at U this is the ARAP energy of U.
+  const auto energy = [&](const MatrixXd & X, const MatrixXd & B)->double
+  {
+    return 0.5*(X.transpose()*data.Q*X).trace() + (X.transpose()*B).trace();
+  };
+  const bool accelerate = data.anderson_m > 0;
+  AndersonAcceleration<double> aa;
+  MatrixXd U_plain;
+  double E_prev = std::numeric_limits<double>::infinity();
+  data.residuals.clear();
+  while(iter < max_iter)
+  {
+    // enforce boundary conditions exactly
+    for(int bi = 0;bi<bc.rows();bi++)
+    {
+      U.row(data.b(bi)) = bc.row(bi);
+    }
+    MatrixXd B = local_step(U);
+    if(accelerate && iter > 0)
+    {
+      // Safeguard: reject accelerated iterates increasing the energy
+      double E = energy(U,B);
+      if(E > E_prev)
+      {
+        U = U_plain;
+        aa.restart(Map<const VectorXd>(U.data(),U.size()));
+        B = local_step(U);
+        E = energy(U,B);
+      }
+      E_prev = E;
+    }
+    U_prev = U;
+
+    {
+      // Solve for all dimensions at once
+      MatrixXd Usol,bcd,Beq;
       if(bc.size()>0)
       {
-        bcc = bc.col(c);
+        bcd = bc.template cast<double>();
+      }else
+      {
+        bcd.resize(0,data.dim);
       }
-      min_quad_with_fixed_solve(
-        data.solver_data,
-        Bc,bcc,Beq,
-        Uc);
-      U.col(c) = Uc;
+      min_quad_with_fixed_solve(data.solver_data,B,bcd,Beq,Usol);
+      U = Usol.template cast<typename DerivedU::Scalar>();
     }
 
+    if(accelerate)
+    {
+      if(iter == 0)
+      {
+        aa.init(data.anderson_m,Map<const VectorXd>(U_prev.data(),U_prev.size()));
+      }
+      U_plain = U;
+      const VectorXd & x = aa.compute(Map<const VectorXd>(U.data(),U.size()));
+      U = Map<const MatrixXd>(x.data(),n,data.dim);
+      data.residuals.push_back(aa.residual());
+    }else
+    {
+      data.residuals.push_back((U-U_prev).norm());
+    }
     iter++;
   }
+  if(accelerate && iter > 0)
+  {
+    // The last accelerated iterate has not been checked
+    U = U_plain;
+  }
   if(data.with_dynamics)
   {
     // Keep track of velocity for next time
     data.vel = (U-U0)/data.h;
   }
+  if(L > 0)
+  {
+    data.level_times[L] = timer.getElapsedTimeInSec();
+  }
 
   return true;
 }
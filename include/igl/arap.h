@@ -12,6 +12,8 @@
 #include "ARAPEnergyType.h"
 #include <Eigen/Core>
 #include <Eigen/Sparse>
+#include <memory>
+#include <vector>
 
 namespace igl
 {
@@ -28,11 +30,45 @@ namespace igl
     // h  dynamics time step
     // ym  ~Young's modulus smaller is softer, larger is more rigid/stiff
     // max_iter  maximum inner iterations
+    // anderson_m  if > 0, accelerate iterations with Anderson acceleration
+    //   using this window size (see igl::AndersonAcceleration) {0}
+    // residuals  #iterations list of fixed-point residual norms |G(U)-U| of
+    //   the last call to arap_solve
     // K  rhs pre-multiplier
+    // Q  system matrix of the global step
     // M  mass matrix
     // solver_data  quadratic solver data
     // b  list of boundary indices into V
     // dim  dimension being used for solving
+    //
+    // Multi-resolution mode (3D triangle meshes with dim = 3): if levels > 0
+    // then arap_precomputation also builds a hierarchy of up to `levels`
+    // coarser meshes by repeated decimation, and arap_solve first solves on
+    // the coarsest mesh (warm started from its previous solution), then
+    // prolongates each level's displacements to the next finer one and runs
+    // a few more iterations there. The input guess U is replaced by the
+    // prolongated coarse solution.
+    //
+    // levels  number of coarser levels (need to call arap_precomputation
+    //   after changing) {0: single resolution}
+    // decimation_ratio  fraction of faces kept from one level to the next
+    // level_iters  levels+1 list of iterations per level, coarsest first and
+    //   this mesh last {empty: max_iter on each level}
+    // coarse  per level precomputation, coarsest first
+    // coarse_U  per level current solution
+    // coarse_bc  per level #b_l by #b matrix mapping bc to the level's
+    //   boundary conditions (handles snap to their closest coarse vertex)
+    // coarse_bc_offset  per level #b_l by dim rest offsets of the snapped
+    //   handles, so that handle displacements (rather than positions) carry
+    //   over: bc_l = coarse_bc_l * bc + coarse_bc_offset_l
+    // coarse_I  per level #V_l list of indices into V of birth vertices (used
+    //   to transfer groups G and external forces f_ext)
+    // prolongation  per level #V_{l+1} by #V_l barycentric interpolation onto
+    //   the next finer level (the last one onto this mesh)
+    // prolongation_offset  per level #V_{l+1} by dim offsets so that the
+    //   rest mesh is reproduced: U_{l+1} = P_l U_l + offset_l
+    // level_times  levels+1 list of seconds spent on each level (including
+    //   prolongation onto it) by the last call to arap_solve
     int n;
     Eigen::VectorXi G;
     ARAPEnergyType energy;
@@ -41,11 +77,22 @@ namespace igl
     double h;
     double ym;
     int max_iter;
-    Eigen::SparseMatrix<double> K,M;
+    int anderson_m;
+    std::vector<double> residuals;
+    Eigen::SparseMatrix<double> K,Q,M;
     Eigen::SparseMatrix<double> CSM;
     min_quad_with_fixed_data<double> solver_data;
     Eigen::VectorXi b;
     int dim;
+    int levels;
+    double decimation_ratio;
+    std::vector<int> level_iters;
+    std::vector<std::shared_ptr<ARAPData> > coarse;
+    std::vector<Eigen::MatrixXd> coarse_U;
+    std::vector<Eigen::SparseMatrix<double> > coarse_bc,prolongation;
+    std::vector<Eigen::MatrixXd> coarse_bc_offset,prolongation_offset;
+    std::vector<Eigen::VectorXi> coarse_I;
+    std::vector<double> level_times;
       ARAPData():
         n(0),
         G(),
@@ -55,11 +102,15 @@ namespace igl
         h(1),
         ym(1),
         max_iter(10),
+        anderson_m(0),
+        residuals(),
         K(),
         CSM(),
         solver_data(),
         b(),
-        dim(-1) // force this to be set by _precomputation
+        dim(-1), // force this to be set by _precomputation
+        levels(0),
+        decimation_ratio(0.25)
     {
     };
   };
@@ -6,11 +6,14 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "bbw.h"
-#include "min_quad_with_fixed.h"
 #include "harmonic.h"
 #include "parallel_for.h"
+#include "slice.h"
 #include <Eigen/Sparse>
+#include <Eigen/OrderingMethods>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <mutex>
 #include <cstdio>
 
@@ -32,6 +35,13 @@ void igl::BBWData::print()
 }
 
 
+namespace igl
+{
+  // Changes of the active set (w.r.t. the last factorization) up to this size
+  // are handled with a Schur complement instead of a new factorization
+  const int BBW_MAX_SCHUR_SIZE = 64;
+}
+
 template <
   typename DerivedV,
   typename DerivedEle,
@@ -49,6 +59,8 @@ IGL_INLINE bool igl::bbw(
 {
   using namespace std;
   using namespace Eigen;
+  typedef SparseMatrix<double> SparseMatrixd;
+  typedef SimplicialLLT<SparseMatrixd,Lower,NaturalOrdering<int> > LLT;
   assert(!data.partition_unity && "partition_unity not implemented yet");
   // number of domain vertices
   int n = V.rows();
@@ -58,14 +70,61 @@ IGL_INLINE bool igl::bbw(
   Eigen::SparseMatrix<typename DerivedV::Scalar> Q;
   harmonic(V,Ele,2,Q);
   W.derived().resize(n,m);
-  // No linear terms
-  VectorXd c = VectorXd::Zero(n);
-  // No linear constraints
-  SparseMatrix<typename DerivedW::Scalar> A(0,n),Aeq(0,n),Aieq(0,n);
-  VectorXd Beq(0,1),Bieq(0,1);
-  // Upper and lower box constraints (Constant bounds)
-  VectorXd ux = VectorXd::Ones(n);
-  VectorXd lx = VectorXd::Zero(n);
+  // Each handle minimizes ½ w'Qw subject to w(b) = bc(:,i) and 0 ≤ w ≤ 1
+  // with an active set method where the active bounds fix more and more
+  // free variables. All of these problems share the matrix K = Q(free,free)
+  // so its fill-reducing ordering and factorization are computed once and
+  // shared by all handles. Each iteration's system differs from the last
+  // factored one by a few fixed/freed variables, which are handled as a
+  // bordered system (Schur complement). Only when too many variables
+  // changed is K(unfixed,unfixed) refactored, under the ordering induced by
+  // the shared one (skipping symbolic reordering).
+  VectorXi free;
+  {
+    vector<bool> is_free(n,true);
+    for(int k = 0;k<b.size();k++)
+    {
+      is_free[b(k)] = false;
+    }
+    free.resize(n-b.size());
+    int f = 0;
+    for(int v = 0;v<n;v++)
+    {
+      if(is_free[v])
+      {
+        free(f++) = v;
+      }
+    }
+    free.conservativeResize(f);
+  }
+  const int nf = free.size();
+  const VectorXi bb = b;
+  SparseMatrixd K,Kfb;
+  {
+    const SparseMatrixd Qd = Q.template cast<double>();
+    slice(Qd,free,free,K);
+    slice(Qd,free,bb,Kfb);
+  }
+  // Shared fill-reducing ordering: Kp(P(i),P(j)) = K(i,j)
+  PermutationMatrix<Dynamic,Dynamic,int> P;
+  {
+    PermutationMatrix<Dynamic,Dynamic,int> Pinv;
+    AMDOrdering<int> ordering;
+    ordering(K,Pinv);
+    P = Pinv.inverse();
+  }
+  SparseMatrixd Kp;
+  Kp = K.twistedBy(P);
+  LLT llt;
+  llt.compute(Kp);
+  if(llt.info() != Eigen::Success)
+  {
+    cerr<<"BBW: factorization of biharmonic operator failed."<<endl;
+    return false;
+  }
+  // Unconstrained minimizers (in permuted order), also the initial guesses
+  const MatrixXd G = Kfb*bc.template cast<double>();
+  const MatrixXd U0 = -llt.solve(P*G);
   active_set_params eff_params = data.active_set_params;
   if(data.verbosity >= 1)
   {
@@ -77,11 +136,10 @@ IGL_INLINE bool igl::bbw(
     cout<<"BBW: Computing initial weights for "<<m<<" handle"<<
       (m!=1?"s":"")<<"."<<endl;
   }
-  min_quad_with_fixed_data<typename DerivedW::Scalar > mqwf;
-  min_quad_with_fixed_precompute(Q,b,Aeq,true,mqwf);
-  min_quad_with_fixed_solve(mqwf,c,bc,Beq,W);
   // decrement
   eff_params.max_iter--;
+  const double lx = 0;
+  const double ux = 1;
   bool error = false;
   // Loop over handles
   std::mutex critical;
@@ -98,12 +156,262 @@ IGL_INLINE bool igl::bbw(
       cout<<"BBW: Computing weight for handle "<<i+1<<" out of "<<m<<
         "."<<endl;
     }
-    VectorXd bci = bc.col(i);
-    VectorXd Wi;
-    // use initial guess
-    Wi = W.col(i);
-    SolverStatus ret = active_set(
-        Q,c,b,bci,Aeq,Beq,Aieq,Bieq,lx,ux,eff_params,Wi);
+    // Everything below is in the shared permuted order
+    const VectorXd g = P*G.col(i);
+    const VectorXd u = U0.col(i);
+    VectorXd x = u;
+    VectorXd old_x = VectorXd::Constant(nf,numeric_limits<double>::max());
+    vector<bool> as_lx(nf,false),as_ux(nf,false);
+    // Reference factorization: K restricted to the variables not fixed in
+    // ref_fixed, initially the shared one (nothing fixed). ref_J maps
+    // variables to rows of the reference system (-1 if fixed).
+    LLT llt_i;
+    const LLT * ref = &llt;
+    vector<bool> ref_fixed(nf,false);
+    VectorXi ref_J = VectorXi::LinSpaced(nf,0,nf-1);
+    // Cached solves against the reference factorization, keyed by the border
+    // column they correspond to (see below)
+    std::map<int,VectorXd> Kinv;
+    SolverStatus ret = SOLVER_STATUS_ERROR;
+    int iter = 0;
+    while(true)
+    {
+      // FIND BREACHES OF CONSTRAINTS
+      for(int z = 0;z<nf;z++)
+      {
+        if(x(z) < lx)
+        {
+          as_lx[z] = true;
+        }
+        if(x(z) > ux)
+        {
+          as_ux[z] = true;
+        }
+      }
+      if((x-old_x).squaredNorm() < eff_params.solution_diff_threshold)
+      {
+        ret = SOLVER_STATUS_CONVERGED;
+        break;
+      }
+      old_x = x;
+      // Active variables (lower bounds first) and their fixed values
+      vector<int> S;
+      vector<double> yS;
+      for(int z = 0;z<nf;z++)
+      {
+        if(as_lx[z])
+        {
+          S.push_back(z);
+          yS.push_back(lx);
+        }
+      }
+      const int as_lx_count = S.size();
+      for(int z = 0;z<nf;z++)
+      {
+        if(as_ux[z] && !as_lx[z])
+        {
+          S.push_back(z);
+          yS.push_back(ux);
+        }
+      }
+      const int ns = S.size();
+      vector<bool> fixed(nf,false);
+      VectorXd xS = VectorXd::Zero(nf);
+      for(int s = 0;s<ns;s++)
+      {
+        fixed[S[s]] = true;
+        xS(S[s]) = yS[s];
+      }
+      // Variables newly fixed (A) or freed (R) w.r.t. the reference
+      vector<int> A,R;
+      for(int z = 0;z<nf;z++)
+      {
+        if(fixed[z] && !ref_fixed[z])
+        {
+          A.push_back(z);
+        }else if(!fixed[z] && ref_fixed[z])
+        {
+          R.push_back(z);
+        }
+      }
+      if(ns == nf)
+      {
+        x = xS;
+      }else
+      {
+        if((int)(A.size()+R.size()) > BBW_MAX_SCHUR_SIZE)
+        {
+          // Too many changes: refactor K(unfixed,unfixed). Its rows keep the
+          // relative (shared) order, so no symbolic reordering is needed.
+          ref_J.setConstant(-1);
+          int nu = 0;
+          for(int z = 0;z<nf;z++)
+          {
+            if(!fixed[z])
+            {
+              ref_J(z) = nu++;
+            }
+          }
+          // Lower triangle is enough
+          SparseMatrixd Kuu(nu,nu);
+          {
+            vector<Triplet<double> > IJV;
+            IJV.reserve(Kp.nonZeros()/2+nf);
+            for(int z = 0;z<nf;z++)
+            {
+              if(fixed[z])
+              {
+                continue;
+              }
+              for(SparseMatrixd::InnerIterator it(Kp,z);it;++it)
+              {
+                if(it.row() >= z && ref_J(it.row()) >= 0)
+                {
+                  IJV.emplace_back(ref_J(it.row()),ref_J(z),it.value());
+                }
+              }
+            }
+            Kuu.setFromTriplets(IJV.begin(),IJV.end());
+          }
+          llt_i.compute(Kuu);
+          if(llt_i.info() != Eigen::Success)
+          {
+            cerr<<"BBW: factorization of reduced system failed."<<endl;
+            error = true;
+            return;
+          }
+          ref = &llt_i;
+          ref_fixed = fixed;
+          Kinv.clear();
+          A.clear();
+          R.clear();
+        }
+        // Bordered system around the reference matrix K0:
+        //
+        //   [K0  C][x0] = [r0]   C = [K(ref,R) E_A],  D = [K(R,R) 0]
+        //   [C'  D][ w]   [rw]                            [  0    0]
+        //
+        // where w = [x_R;λ_A] and λ_A are the multipliers fixing x_A = y_A.
+        // Eliminating x0 leaves the small dense Schur complement
+        // (D - C'K0⁻¹C) w = rw - C'K0⁻¹r0.
+        //
+        // x_A are unknowns of x0 (pinned by the multipliers), so only the
+        // variables fixed in the reference too may be moved to the right
+        // hand side: otherwise K(:,A) y_A would be counted twice.
+        const int n0 = ref_J.maxCoeff()+1;
+        VectorXd xS0 = xS;
+        for(const int a : A)
+        {
+          xS0(a) = 0;
+        }
+        const VectorXd KxS = Kp*xS0;
+        VectorXd r0(n0);
+        for(int z = 0;z<nf;z++)
+        {
+          if(ref_J(z) >= 0)
+          {
+            r0(ref_J(z)) = fixed[z] ? 0 : -g(z)-KxS(z);
+          }
+        }
+        const int nr = R.size();
+        const int k = nr+A.size();
+        // Border columns: K(ref,R(j)) keyed by -1-R(j), e_A(j) keyed by A(j)
+        const auto border = [&](const int j)->VectorXd
+        {
+          VectorXd c = VectorXd::Zero(n0);
+          if(j < nr)
+          {
+            for(SparseMatrixd::InnerIterator it(Kp,R[j]);it;++it)
+            {
+              if(ref_J(it.row()) >= 0)
+              {
+                c(ref_J(it.row())) = it.value();
+              }
+            }
+          }else
+          {
+            c(ref_J(A[j-nr])) = 1;
+          }
+          return c;
+        };
+        MatrixXd C(n0,k),Z(n0,k);
+        for(int j = 0;j<k;j++)
+        {
+          const int key = j < nr ? -1-R[j] : A[j-nr];
+          C.col(j) = border(j);
+          auto it = Kinv.find(key);
+          if(it == Kinv.end())
+          {
+            it = Kinv.emplace(key,ref->solve(C.col(j))).first;
+          }
+          Z.col(j) = it->second;
+        }
+        const VectorXd z0 = ref->solve(r0);
+        x = xS;
+        if(k == 0)
+        {
+          for(int z = 0;z<nf;z++)
+          {
+            if(ref_J(z) >= 0 && !fixed[z])
+            {
+              x(z) = z0(ref_J(z));
+            }
+          }
+        }else
+        {
+          MatrixXd M = -C.transpose()*Z;
+          VectorXd rw = -C.transpose()*z0;
+          for(int i = 0;i<nr;i++)
+          {
+            for(int j = 0;j<nr;j++)
+            {
+              M(i,j) += Kp.coeff(R[i],R[j]);
+            }
+            rw(i) += -g(R[i])-KxS(R[i]);
+          }
+          for(int i = nr;i<k;i++)
+          {
+            rw(i) += as_lx[A[i-nr]] ? lx : ux;
+          }
+          const VectorXd w = M.partialPivLu().solve(rw);
+          const VectorXd x0 = z0 - Z*w;
+          for(int z = 0;z<nf;z++)
+          {
+            if(ref_J(z) >= 0 && !fixed[z])
+            {
+              x(z) = x0(ref_J(z));
+            }
+          }
+          for(int j = 0;j<nr;j++)
+          {
+            x(R[j]) = w(j);
+          }
+        }
+      }
+      // Gradient K x + g at the active variables
+      const VectorXd Kx = Kp*x;
+      VectorXd grad_S(ns);
+      for(int s = 0;s<ns;s++)
+      {
+        grad_S(s) = Kx(S[s]) + g(S[s]);
+      }
+      // Remove from active set: Lagrange multipliers (½ of the gradient, see
+      // active_set) with the wrong sign
+      for(int s = 0;s<ns;s++)
+      {
+        const double lambda = (s < as_lx_count ? 0.5 : -0.5)*grad_S(s);
+        if(lambda < eff_params.inactive_threshold)
+        {
+          (s < as_lx_count ? as_lx : as_ux)[S[s]] = false;
+        }
+      }
+      iter++;
+      if(eff_params.max_iter>0 && iter>=eff_params.max_iter)
+      {
+        ret = SOLVER_STATUS_MAX_ITER;
+        break;
+      }
+    }
     switch(ret)
     {
       case SOLVER_STATUS_CONVERGED:
@@ -116,7 +424,15 @@ IGL_INLINE bool igl::bbw(
         cerr<<"active_set error."<<endl;
         error = true;
     }
-    W.col(i) = Wi;
+    // Scatter back to original order
+    for(int k = 0;k<bb.size();k++)
+    {
+      W(bb(k),i) = bc(k,i);
+    }
+    for(int f = 0;f<nf;f++)
+    {
+      W(free(f),i) = x(P.indices()(f));
+    }
   };
   parallel_for(m,optimize_weight,2);
   if(error)
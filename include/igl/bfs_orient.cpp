@@ -7,6 +7,7 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "bfs_orient.h"
 #include "orientable_patches.h"
+#include "parallel_for.h"
 #include <Eigen/Sparse>
 #include <queue>
 
@@ -34,21 +35,19 @@ IGL_INLINE void igl::bfs_orient(
   {
     FF = F;
   }
+  // first member of each patch (patches are numbered in order of their first
+  // member)
+  VectorXi first = VectorXi::Constant(num_cc,-1);
+  for(int f = m-1;f>=0;f--)
+  {
+    first(C(f)) = f;
+  }
   // loop over patches
-#pragma omp parallel for
-  for(int c = 0;c<num_cc;c++)
+  parallel_for(num_cc,[&](const int c)
   {
     queue<int> Q;
-    // find first member of patch c
-    for(int f = 0;f<FF.rows();f++)
-    {
-      if(C(f) == c)
-      {
-        Q.push(f);
-        break;
-      }
-    }
-    assert(!Q.empty());
+    Q.push(first(c));
+    assert(first(c) >= 0);
     while(!Q.empty())
     {
       const int f = Q.front();
@@ -89,7 +88,7 @@ IGL_INLINE void igl::bfs_orient(
         }
       }
     }
-  }
+  },2);
 
   // make sure flip is OK if &FF = &F
 }
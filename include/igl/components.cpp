@@ -6,9 +6,8 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "components.h"
-#include "adjacency_matrix.h"
-#include <queue>
-#include <vector>
+#include "parallel_for.h"
+#include "UnionFind.h"
 
 template <typename AScalar, typename DerivedC, typename Derivedcounts>
 IGL_INLINE void igl::components(
@@ -16,55 +15,20 @@ IGL_INLINE void igl::components(
   Eigen::PlainObjectBase<DerivedC> & C,
   Eigen::PlainObjectBase<Derivedcounts> & counts)
 {
-  using namespace Eigen;
-  using namespace std;
   assert(A.rows() == A.cols() && "A should be square.");
-  const size_t n = A.rows();
-  Array<bool,Dynamic,1> seen = Array<bool,Dynamic,1>::Zero(n,1);
-  C.resize(n,1);
-  typename DerivedC::Scalar id = 0;
-  vector<typename Derivedcounts::Scalar> vcounts;
-  // breadth first search
-  for(int k=0; k<A.outerSize(); ++k)
+  const int n = A.rows();
+  UnionFind uf(n);
+  parallel_for(A.outerSize(),[&A,&uf](const int k)
   {
-    if(seen(k))
+    for(typename Eigen::SparseMatrix<AScalar>::InnerIterator it (A,k); it; ++it)
     {
-      continue;
-    }
-    queue<int> Q;
-    Q.push(k);
-    vcounts.push_back(0);
-    while(!Q.empty())
-    {
-      const int f = Q.front();
-      Q.pop();
-      if(seen(f))
-      {
-        continue;
-      }
-      seen(f) = true;
-      C(f,0) = id;
-      vcounts[id]++;
-      // Iterate over inside
-      for(typename SparseMatrix<AScalar>::InnerIterator it (A,f); it; ++it)
+      if(it.value())
       {
-        const int g = it.index();
-        if(!seen(g) && it.value())
-        {
-          Q.push(g);
-        }
+        uf.unite(k,it.index());
       }
     }
-    id++;
-  }
-  assert((size_t) id == vcounts.size());
-  const size_t ncc = vcounts.size();
-  assert((size_t)C.maxCoeff()+1 == ncc);
-  counts.resize(ncc,1);
-  for(size_t i = 0;i<ncc;i++)
-  {
-    counts(i) = vcounts[i];
-  }
+  },1000);
+  uf.labels(C,counts);
 }
 
 template <typename AScalar, typename DerivedC>
@@ -81,9 +45,17 @@ IGL_INLINE void igl::components(
   const Eigen::MatrixBase<DerivedF> & F,
   Eigen::PlainObjectBase<DerivedC> & C)
 {
-  Eigen::SparseMatrix<typename DerivedC::Scalar> A;
-  adjacency_matrix(F,A);
-  return components(A,C);
+  // Vertices of each simplex are connected by its edges
+  const int n = F.size() == 0 ? 0 : F.maxCoeff()+1;
+  UnionFind uf(n);
+  parallel_for(F.rows(),[&F,&uf](const int f)
+  {
+    for(int c = 1;c<F.cols();c++)
+    {
+      uf.unite(F(f,0),F(f,c));
+    }
+  },1000);
+  uf.labels(C);
 }
 
 #ifdef IGL_STATIC_LIBRARY
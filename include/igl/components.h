@@ -14,6 +14,8 @@ namespace igl
 {
   // Compute connected components of a graph represented by an adjacency
   // matrix. This version is faster than the previous version using boost.
+  // Components are found with a concurrent union-find (see igl::UnionFind)
+  // and numbered in order of their smallest index.
   //
   // Inputs:
   //   A  n by n adjacency matrix
@@ -0,0 +1,265 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "compressed_skinning.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace igl
+{
+  // Number of vertices processed by one task of the skinning kernels
+  const int COMPRESSED_SKINNING_BLOCK = 512;
+  // Call kernel(m,i0,i1) for blocks [i0,i1) of the vertices of all meshes m
+  // in parallel
+  template <typename KernelType>
+  IGL_INLINE void compressed_skinning_blocks(
+    const std::vector<const CompressedSkinningData *> & data,
+    const KernelType & kernel)
+  {
+    std::vector<std::pair<int,int> > tasks;
+    for(int m = 0;m<(int)data.size();m++)
+    {
+      for(int i0 = 0;i0<data[m]->V.rows();i0 += COMPRESSED_SKINNING_BLOCK)
+      {
+        tasks.emplace_back(m,i0);
+      }
+    }
+    parallel_for(tasks.size(),[&](const int t)
+    {
+      const int m = tasks[t].first;
+      const int i0 = tasks[t].second;
+      kernel(
+        m,i0,std::min(i0+COMPRESSED_SKINNING_BLOCK,int(data[m]->V.rows())));
+    },2);
+  }
+}
+
+IGL_INLINE void igl::compressed_skinning_precompute(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXd & W,
+  const int k,
+  CompressedSkinningData & data)
+{
+  assert(V.cols() == 3 && "V should be #V by 3");
+  assert(W.rows() >= V.rows() && "W should have a row per vertex");
+  assert(k > 0 && "k should be positive");
+  const int nv = V.rows();
+  const int nh = W.cols();
+  const int kk = std::min(k,nh);
+  data.num_handles = nh;
+  data.V = V.cast<float>();
+  data.I.setZero(nv,kk);
+  data.W.setZero(nv,kk);
+  parallel_for(nv,[&](const int i)
+  {
+    std::vector<int> order(nh);
+    std::iota(order.begin(),order.end(),0);
+    std::partial_sort(order.begin(),order.begin()+kk,order.end(),
+      [&W,&i](const int a, const int b){ return W(i,a) > W(i,b); });
+    double sum = 0;
+    for(int j = 0;j<kk;j++)
+    {
+      sum += std::max(W(i,order[j]),0.0);
+    }
+    if(!(sum > 0))
+    {
+      // No positive weight: follow the largest
+      data.I(i,0) = order[0];
+      data.W(i,0) = 65535;
+      return;
+    }
+    int total = 0;
+    for(int j = 0;j<kk;j++)
+    {
+      const double w = std::max(W(i,order[j]),0.0)/sum;
+      data.I(i,j) = w > 0 ? order[j] : 0;
+      data.W(i,j) = (unsigned short)std::lround(65535.0*w);
+      total += data.W(i,j);
+    }
+    // Rounding error goes to the largest weight, so weights sum to one
+    data.W(i,0) = (unsigned short)(int(data.W(i,0)) + 65535 - total);
+  },1000);
+}
+
+IGL_INLINE void igl::compressed_skinning_lbs(
+  const std::vector<const CompressedSkinningData *> & data,
+  const std::vector<const Eigen::MatrixXf *> & T,
+  const std::vector<float *> & U)
+{
+  assert(T.size() == data.size() && U.size() == data.size());
+  // Per handle 4 by 3 transformations, contiguous
+  std::vector<std::vector<float> > packed(data.size());
+  for(int m = 0;m<(int)data.size();m++)
+  {
+    const Eigen::MatrixXf & Tm = *T[m];
+    assert(Tm.rows() == 4*data[m]->num_handles && Tm.cols() == 3);
+    packed[m].resize(Tm.size());
+    for(int c = 0;c<data[m]->num_handles;c++)
+    {
+      for(int r = 0;r<4;r++)
+      {
+        for(int d = 0;d<3;d++)
+        {
+          packed[m][c*12+r*3+d] = Tm(4*c+r,d);
+        }
+      }
+    }
+  }
+  compressed_skinning_blocks(data,[&](const int m, const int i0, const int i1)
+  {
+    const CompressedSkinningData & d = *data[m];
+    const int nv = d.V.rows();
+    const int nb = i1-i0;
+    const float * Vx = d.V.data()+i0;
+    const float * Vy = Vx+nv;
+    const float * Vz = Vy+nv;
+    const float * Tm = packed[m].data();
+    float ux[COMPRESSED_SKINNING_BLOCK] = {0};
+    float uy[COMPRESSED_SKINNING_BLOCK] = {0};
+    float uz[COMPRESSED_SKINNING_BLOCK] = {0};
+    for(int s = 0;s<d.I.cols();s++)
+    {
+      const int * Is = d.I.data()+s*nv+i0;
+      const unsigned short * Ws = d.W.data()+s*nv+i0;
+      for(int j = 0;j<nb;j++)
+      {
+        const float w = float(Ws[j])*(1.0f/65535.0f);
+        const float * t = Tm+12*Is[j];
+        const float x = Vx[j], y = Vy[j], z = Vz[j];
+        ux[j] += w*(x*t[0]+y*t[3]+z*t[6]+t[ 9]);
+        uy[j] += w*(x*t[1]+y*t[4]+z*t[7]+t[10]);
+        uz[j] += w*(x*t[2]+y*t[5]+z*t[8]+t[11]);
+      }
+    }
+    float * Um = U[m]+3*i0;
+    for(int j = 0;j<nb;j++)
+    {
+      Um[3*j+0] = ux[j];
+      Um[3*j+1] = uy[j];
+      Um[3*j+2] = uz[j];
+    }
+  });
+}
+
+IGL_INLINE void igl::compressed_skinning_lbs(
+  const CompressedSkinningData & data,
+  const Eigen::MatrixXf & T,
+  float * U)
+{
+  return compressed_skinning_lbs(
+    std::vector<const CompressedSkinningData *>(1,&data),
+    std::vector<const Eigen::MatrixXf *>(1,&T),
+    std::vector<float *>(1,U));
+}
+
+IGL_INLINE void igl::compressed_skinning_dqs(
+  const std::vector<const CompressedSkinningData *> & data,
+  const std::vector<const CompressedSkinningRotationList *> & vQ,
+  const std::vector<const CompressedSkinningTranslationList *> & vT,
+  const std::vector<float *> & U)
+{
+  assert(vQ.size() == data.size());
+  assert(vT.size() == data.size());
+  assert(U.size() == data.size());
+  // Per handle dual quaternions: real part (w,x,y,z), dual part (w,x,y,z)
+  std::vector<std::vector<float> > packed(data.size());
+  for(int m = 0;m<(int)data.size();m++)
+  {
+    const int nh = data[m]->num_handles;
+    assert((int)vQ[m]->size() == nh && (int)vT[m]->size() == nh);
+    packed[m].resize(8*nh);
+    for(int c = 0;c<nh;c++)
+    {
+      const Eigen::Quaternionf & q = (*vQ[m])[c];
+      const Eigen::Vector3f & t = (*vT[m])[c];
+      float * p = packed[m].data()+8*c;
+      p[0] = q.w();
+      p[1] = q.x();
+      p[2] = q.y();
+      p[3] = q.z();
+      p[4] = -0.5f*( t(0)*q.x() + t(1)*q.y() + t(2)*q.z());
+      p[5] =  0.5f*( t(0)*q.w() + t(1)*q.z() - t(2)*q.y());
+      p[6] =  0.5f*(-t(0)*q.z() + t(1)*q.w() + t(2)*q.x());
+      p[7] =  0.5f*( t(0)*q.y() - t(1)*q.x() + t(2)*q.w());
+    }
+  }
+  compressed_skinning_blocks(data,[&](const int m, const int i0, const int i1)
+  {
+    const CompressedSkinningData & d = *data[m];
+    const int nv = d.V.rows();
+    const int nb = i1-i0;
+    const float * Vx = d.V.data()+i0;
+    const float * Vy = Vx+nv;
+    const float * Vz = Vy+nv;
+    const float * Qm = packed[m].data();
+    // Blended dual quaternions
+    float b[8][COMPRESSED_SKINNING_BLOCK] = {{0}};
+    // Real part of each vertex's first influence: q and -q are the same
+    // rotation, so others are flipped into its hemisphere before blending
+    float r[4][COMPRESSED_SKINNING_BLOCK];
+    for(int s = 0;s<d.I.cols();s++)
+    {
+      const int * Is = d.I.data()+s*nv+i0;
+      const unsigned short * Ws = d.W.data()+s*nv+i0;
+      for(int j = 0;j<nb;j++)
+      {
+        const float * q = Qm+8*Is[j];
+        if(s == 0)
+        {
+          for(int c = 0;c<4;c++)
+          {
+            r[c][j] = q[c];
+          }
+        }
+        const float dot =
+          r[0][j]*q[0] + r[1][j]*q[1] + r[2][j]*q[2] + r[3][j]*q[3];
+        const float w =
+          (dot < 0 ? -1.0f : 1.0f)*float(Ws[j])*(1.0f/65535.0f);
+        for(int c = 0;c<8;c++)
+        {
+          b[c][j] += w*q[c];
+        }
+      }
+    }
+    float * Um = U[m]+3*i0;
+    for(int j = 0;j<nb;j++)
+    {
+      // See algorithm 1 in "Geometric skinning with approximate dual
+      // quaternion blending" by Kavan et al
+      const float inv_norm = 1.0f/std::sqrt(
+        b[0][j]*b[0][j]+b[1][j]*b[1][j]+b[2][j]*b[2][j]+b[3][j]*b[3][j]);
+      const float a0 = b[0][j]*inv_norm;
+      const Eigen::Vector3f d0(
+        b[1][j]*inv_norm,b[2][j]*inv_norm,b[3][j]*inv_norm);
+      const float ae = b[4][j]*inv_norm;
+      const Eigen::Vector3f de(
+        b[5][j]*inv_norm,b[6][j]*inv_norm,b[7][j]*inv_norm);
+      const Eigen::Vector3f v(Vx[j],Vy[j],Vz[j]);
+      const Eigen::Vector3f u =
+        v + 2*d0.cross(d0.cross(v) + a0*v) + 2*(a0*de - ae*d0 + d0.cross(de));
+      Um[3*j+0] = u(0);
+      Um[3*j+1] = u(1);
+      Um[3*j+2] = u(2);
+    }
+  });
+}
+
+IGL_INLINE void igl::compressed_skinning_dqs(
+  const CompressedSkinningData & data,
+  const CompressedSkinningRotationList & vQ,
+  const CompressedSkinningTranslationList & vT,
+  float * U)
+{
+  return compressed_skinning_dqs(
+    std::vector<const CompressedSkinningData *>(1,&data),
+    std::vector<const CompressedSkinningRotationList *>(1,&vQ),
+    std::vector<const CompressedSkinningTranslationList *>(1,&vT),
+    std::vector<float *>(1,U));
+}
@@ -0,0 +1,102 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_COMPRESSED_SKINNING_H
+#define IGL_COMPRESSED_SKINNING_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+#include <vector>
+
+namespace igl
+{
+  // Skinning weights compressed for per-frame evaluation of many skinned
+  // meshes: each vertex keeps its k largest weights, quantized to 16 bits
+  // (summing exactly to 65535), and all per-vertex data is stored as
+  // structure of arrays (Eigen's column-major #V by k matrices), so the
+  // skinning kernels stream through contiguous memory and vectorize.
+  struct CompressedSkinningData
+  {
+    // Number of handles (columns of the uncompressed weights)
+    int num_handles;
+    // #V by 3 list of rest positions (one array per coordinate)
+    Eigen::MatrixXf V;
+    // #V by k list of handle indices of each vertex's influences (unused
+    // influences have index 0 and weight 0)
+    Eigen::MatrixXi I;
+    // #V by k list of quantized weights (weight = W(i,j)/65535)
+    Eigen::Matrix<unsigned short,Eigen::Dynamic,Eigen::Dynamic> W;
+    CompressedSkinningData():
+      num_handles(0),V(),I(),W()
+    {};
+  };
+  typedef std::vector<
+    Eigen::Quaternionf,Eigen::aligned_allocator<Eigen::Quaternionf> >
+    CompressedSkinningRotationList;
+  typedef std::vector<Eigen::Vector3f> CompressedSkinningTranslationList;
+
+  // Compress skinning weights.
+  //
+  // Inputs:
+  //   V  #V by 3 list of rest positions
+  //   W  #V by #handles list of (non-negative) weights; negative weights
+  //     are clamped to zero and each vertex's k largest are renormalized
+  //   k  maximum number of influences per vertex (e.g., 4 or 8)
+  // Outputs:
+  //   data  compressed weights and rest positions
+  IGL_INLINE void compressed_skinning_precompute(
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXd & W,
+    const int k,
+    CompressedSkinningData & data);
+  // Linear blend skinning of many meshes at once. Vertex blocks of all
+  // meshes are evaluated in parallel.
+  //
+  // Inputs:
+  //   data  #meshes list of compressed weights
+  //   T  #meshes list of #handles*4 by 3 stacked transposed affine
+  //     transformations (see lbs_matrix)
+  // Outputs:
+  //   U  #meshes list of user buffers of #V*3 floats receiving the deformed
+  //     positions, interleaved x0 y0 z0 x1 y1 z1 ... (e.g., a mapped vertex
+  //     buffer)
+  IGL_INLINE void compressed_skinning_lbs(
+    const std::vector<const CompressedSkinningData *> & data,
+    const std::vector<const Eigen::MatrixXf *> & T,
+    const std::vector<float *> & U);
+  // Single mesh version
+  IGL_INLINE void compressed_skinning_lbs(
+    const CompressedSkinningData & data,
+    const Eigen::MatrixXf & T,
+    float * U);
+  // Dual quaternion skinning (see dqs) of many meshes at once.
+  //
+  // Inputs:
+  //   data  #meshes list of compressed weights
+  //   vQ  #meshes list of #handles lists of rotations
+  //   vT  #meshes list of #handles lists of translations
+  // Outputs:
+  //   U  #meshes list of user buffers of #V*3 interleaved floats
+  IGL_INLINE void compressed_skinning_dqs(
+    const std::vector<const CompressedSkinningData *> & data,
+    const std::vector<const CompressedSkinningRotationList *> & vQ,
+    const std::vector<const CompressedSkinningTranslationList *> & vT,
+    const std::vector<float *> & U);
+  // Single mesh version
+  IGL_INLINE void compressed_skinning_dqs(
+    const CompressedSkinningData & data,
+    const CompressedSkinningRotationList & vQ,
+    const CompressedSkinningTranslationList & vT,
+    float * U);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "compressed_skinning.cpp"
+#endif
+
+#endif
@@ -0,0 +1,425 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_COPYLEFT_CGAL_INCREMENTAL_CSG_TREE_H
+#define IGL_COPYLEFT_CGAL_INCREMENTAL_CSG_TREE_H
+
+#include "CSGTree.h"
+#include "../../MeshBooleanType.h"
+#include <Eigen/Core>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace igl
+{
+  namespace copyleft
+  {
+    namespace cgal
+    {
+      // Class for evaluating a tree (or DAG) of boolean operations on
+      // "solid" triangle meshes lazily and incrementally. Unlike CSGTree,
+      // which computes every node in its constructor, nodes are only
+      // evaluated when requested, and results are memoised by the node's
+      // whole subtree (leaf meshes and operations). Editing a leaf or an
+      // operation only invalidates the nodes on the path(s) to the root; a
+      // subtree identical to one evaluated before (e.g., after undoing an
+      // edit) is not recomputed. Independent sibling subtrees are evaluated
+      // in parallel.
+      //
+      // Example:
+      //   IncrementalCSGTree tree;
+      //   const int a = tree.add_leaf(VA,FA);
+      //   const int b = tree.add_leaf(VB,FB);
+      //   const int c = tree.add_leaf(VC,FC);
+      //   const int ab = tree.add_operation(a,b,MESH_BOOLEAN_TYPE_UNION);
+      //   const int root = tree.add_operation(ab,c,MESH_BOOLEAN_TYPE_MINUS);
+      //   tree.evaluate(root);
+      //   tree.set_leaf(c,VC2,FC); // only root is recomputed below
+      //   const CSGTree & result = tree.evaluate(root);
+      class IncrementalCSGTree
+      {
+        private:
+          struct Node
+          {
+            bool is_leaf;
+            // Leaf mesh
+            Eigen::MatrixXd V;
+            Eigen::MatrixXi F;
+            // Operation on nodes a and b
+            int a,b;
+            MeshBooleanType type;
+            // Nodes using this one as an operand
+            std::vector<int> parents;
+            // Hash of the subtree rooted at this node
+            std::uint64_t hash;
+            // Result (null until evaluated)
+            std::shared_ptr<const CSGTree> result;
+          };
+          // Evaluated subtree. Hashes may collide, so an entry also stores
+          // what identifies the subtree exactly: the mesh of a leaf, or the
+          // operation and the (cached) results of its operands
+          struct CacheEntry
+          {
+            bool is_leaf;
+            Eigen::MatrixXd V;
+            Eigen::MatrixXi F;
+            MeshBooleanType type;
+            std::shared_ptr<const CSGTree> a,b;
+            std::shared_ptr<const CSGTree> result;
+          };
+          std::vector<Node> m_nodes;
+          // Results of all evaluated subtrees by hash
+          std::unordered_multimap<std::uint64_t,CacheEntry> m_cache;
+          std::mutex m_cache_mutex;
+        public:
+          // Evaluate independent subtrees in parallel
+          bool parallel = true;
+          // Add a "leaf" node with identity operation on assumed "solid"
+          // mesh (V,F)
+          //
+          // Inputs:
+          //   V  #V by 3 list of mesh vertices
+          //   F  #F by 3 list of mesh face indices into V
+          // Returns id of the new node
+          inline int add_leaf(const Eigen::MatrixXd & V, const Eigen::MatrixXi & F);
+          // Add a node computing a boolean operation of existing nodes
+          //
+          // Inputs:
+          //   a  id of first operand
+          //   b  id of second operand
+          //   type  type of mesh boolean to compute
+          // Returns id of the new node
+          inline int add_operation(
+            const int a,
+            const int b,
+            const MeshBooleanType & type);
+          // Replace the mesh of a leaf, invalidating all nodes depending on
+          // it
+          //
+          // Inputs:
+          //   id  id of leaf node
+          //   V  #V by 3 list of mesh vertices
+          //   F  #F by 3 list of mesh face indices into V
+          inline void set_leaf(
+            const int id,
+            const Eigen::MatrixXd & V,
+            const Eigen::MatrixXi & F);
+          // Replace the type of an operation, invalidating all nodes
+          // depending on it
+          //
+          // Inputs:
+          //   id  id of operation node
+          //   type  type of mesh boolean to compute
+          inline void set_operation(const int id, const MeshBooleanType & type);
+          // Evaluate a node (and, as needed, its subtree)
+          //
+          // Inputs:
+          //   id  id of node
+          // Returns reference to the result, valid until the node is
+          // invalidated
+          inline const CSGTree & evaluate(const int id);
+          // Returns whether a node has a valid result
+          inline bool is_evaluated(const int id) const;
+          // Drop cached results not used by any current node
+          inline void prune_cache();
+        private:
+          inline static std::uint64_t hash_combine(
+            std::uint64_t h,
+            const void * data,
+            const size_t bytes);
+          inline void update_hash(const int id);
+          // Returns whether a cache entry holds the result of node id, whose
+          // operands (if any) must have been evaluated
+          inline bool matches(const int id, const CacheEntry & entry) const;
+          // Recompute hashes and drop results of id and all nodes depending
+          // on it
+          inline void invalidate(const int id);
+          // Collect hashes of all nodes in the subtree of id
+          inline void subtree_hashes(
+            const int id,
+            std::unordered_set<std::uint64_t> & hashes) const;
+          inline void evaluate(const int id, const int parallel_depth);
+      };
+    }
+  }
+}
+
+// Implementation
+
+inline int igl::copyleft::cgal::IncrementalCSGTree::add_leaf(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F)
+{
+  Node n;
+  n.is_leaf = true;
+  n.V = V;
+  n.F = F;
+  n.a = n.b = -1;
+  n.type = MESH_BOOLEAN_TYPE_UNION;
+  m_nodes.push_back(n);
+  update_hash(m_nodes.size()-1);
+  return m_nodes.size()-1;
+}
+
+inline int igl::copyleft::cgal::IncrementalCSGTree::add_operation(
+  const int a,
+  const int b,
+  const MeshBooleanType & type)
+{
+  assert(a >= 0 && a < (int)m_nodes.size());
+  assert(b >= 0 && b < (int)m_nodes.size());
+  Node n;
+  n.is_leaf = false;
+  n.a = a;
+  n.b = b;
+  n.type = type;
+  m_nodes.push_back(n);
+  const int id = m_nodes.size()-1;
+  m_nodes[a].parents.push_back(id);
+  if(b != a)
+  {
+    m_nodes[b].parents.push_back(id);
+  }
+  update_hash(id);
+  return id;
+}
+
+inline void igl::copyleft::cgal::IncrementalCSGTree::set_leaf(
+  const int id,
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F)
+{
+  assert(m_nodes[id].is_leaf && "id should be a leaf");
+  m_nodes[id].V = V;
+  m_nodes[id].F = F;
+  invalidate(id);
+}
+
+inline void igl::copyleft::cgal::IncrementalCSGTree::set_operation(
+  const int id,
+  const MeshBooleanType & type)
+{
+  assert(!m_nodes[id].is_leaf && "id should be an operation");
+  m_nodes[id].type = type;
+  invalidate(id);
+}
+
+inline const igl::copyleft::cgal::CSGTree &
+  igl::copyleft::cgal::IncrementalCSGTree::evaluate(const int id)
+{
+  // Enough levels of forking to occupy all cores
+  int parallel_depth = 0;
+  if(parallel)
+  {
+    const size_t sthc = std::thread::hardware_concurrency();
+    for(size_t t = 1;t<(sthc == 0 ? 8 : sthc);t *= 2)
+    {
+      parallel_depth++;
+    }
+  }
+  evaluate(id,parallel_depth);
+  return *m_nodes[id].result;
+}
+
+inline bool igl::copyleft::cgal::IncrementalCSGTree::is_evaluated(
+  const int id) const
+{
+  return bool(m_nodes[id].result);
+}
+
+inline void igl::copyleft::cgal::IncrementalCSGTree::prune_cache()
+{
+  std::unordered_set<std::uint64_t> used;
+  for(const auto & n : m_nodes)
+  {
+    used.insert(n.hash);
+  }
+  for(auto it = m_cache.begin();it != m_cache.end();)
+  {
+    if(used.count(it->first) == 0)
+    {
+      it = m_cache.erase(it);
+    }else
+    {
+      ++it;
+    }
+  }
+}
+
+inline std::uint64_t igl::copyleft::cgal::IncrementalCSGTree::hash_combine(
+  std::uint64_t h,
+  const void * data,
+  const size_t bytes)
+{
+  // FNV-1a
+  const unsigned char * p = static_cast<const unsigned char *>(data);
+  for(size_t i = 0;i<bytes;i++)
+  {
+    h ^= p[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+inline void igl::copyleft::cgal::IncrementalCSGTree::update_hash(const int id)
+{
+  Node & n = m_nodes[id];
+  std::uint64_t h = 14695981039346656037ull;
+  h = hash_combine(h,&n.is_leaf,sizeof(bool));
+  if(n.is_leaf)
+  {
+    const Eigen::Index dims[4] = {n.V.rows(),n.V.cols(),n.F.rows(),n.F.cols()};
+    h = hash_combine(h,dims,sizeof(dims));
+    h = hash_combine(h,n.V.data(),sizeof(double)*n.V.size());
+    h = hash_combine(h,n.F.data(),sizeof(int)*n.F.size());
+  }else
+  {
+    const int type = n.type;
+    h = hash_combine(h,&type,sizeof(int));
+    h = hash_combine(h,&m_nodes[n.a].hash,sizeof(std::uint64_t));
+    h = hash_combine(h,&m_nodes[n.b].hash,sizeof(std::uint64_t));
+  }
+  n.hash = h;
+}
+
+inline bool igl::copyleft::cgal::IncrementalCSGTree::matches(
+  const int id,
+  const CacheEntry & entry) const
+{
+  const Node & n = m_nodes[id];
+  if(entry.is_leaf != n.is_leaf)
+  {
+    return false;
+  }
+  if(n.is_leaf)
+  {
+    return
+      entry.V.rows() == n.V.rows() && entry.V.cols() == n.V.cols() &&
+      entry.F.rows() == n.F.rows() && entry.F.cols() == n.F.cols() &&
+      entry.V == n.V && entry.F == n.F;
+  }
+  return
+    entry.type == n.type &&
+    entry.a == m_nodes[n.a].result &&
+    entry.b == m_nodes[n.b].result;
+}
+
+inline void igl::copyleft::cgal::IncrementalCSGTree::invalidate(const int id)
+{
+  // Nodes are only added on top of existing ones, so ids are a
+  // topological order: update dependents in increasing order
+  std::vector<char> dirty(m_nodes.size(),0);
+  dirty[id] = 1;
+  for(int i = id;i<(int)m_nodes.size();i++)
+  {
+    if(!dirty[i])
+    {
+      continue;
+    }
+    update_hash(i);
+    m_nodes[i].result.reset();
+    for(const int p : m_nodes[i].parents)
+    {
+      dirty[p] = 1;
+    }
+  }
+}
+
+inline void igl::copyleft::cgal::IncrementalCSGTree::subtree_hashes(
+  const int id,
+  std::unordered_set<std::uint64_t> & hashes) const
+{
+  const Node & n = m_nodes[id];
+  if(!hashes.insert(n.hash).second)
+  {
+    return;
+  }
+  if(!n.is_leaf)
+  {
+    subtree_hashes(n.a,hashes);
+    subtree_hashes(n.b,hashes);
+  }
+}
+
+inline void igl::copyleft::cgal::IncrementalCSGTree::evaluate(
+  const int id,
+  const int parallel_depth)
+{
+  Node & n = m_nodes[id];
+  if(n.result)
+  {
+    return;
+  }
+  if(!n.is_leaf)
+  {
+    // Operands are needed to identify a cached result (they are cache hits
+    // themselves if this node is)
+    bool fork =
+      parallel_depth > 0 &&
+      !m_nodes[n.a].result &&
+      !m_nodes[n.b].result;
+    if(fork)
+    {
+      // Exact numbers are reference counted: only fork if the operands
+      // share no (cached) subtree
+      std::unordered_set<std::uint64_t> ha,hb;
+      subtree_hashes(n.a,ha);
+      subtree_hashes(n.b,hb);
+      fork = std::none_of(ha.begin(),ha.end(),
+        [&hb](const std::uint64_t h){ return hb.count(h) > 0; });
+    }
+    if(fork)
+    {
+      std::thread ta([&](){ evaluate(n.a,parallel_depth-1); });
+      evaluate(n.b,parallel_depth-1);
+      ta.join();
+    }else
+    {
+      evaluate(n.a,parallel_depth);
+      evaluate(n.b,parallel_depth);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> guard(m_cache_mutex);
+    const auto range = m_cache.equal_range(n.hash);
+    for(auto it = range.first;it != range.second;++it)
+    {
+      if(matches(id,it->second))
+      {
+        n.result = it->second.result;
+        return;
+      }
+    }
+  }
+  CacheEntry entry;
+  entry.is_leaf = n.is_leaf;
+  entry.type = n.type;
+  if(n.is_leaf)
+  {
+    entry.V = n.V;
+    entry.F = n.F;
+    entry.result = std::make_shared<const CSGTree>(n.V,n.F);
+  }else
+  {
+    entry.a = m_nodes[n.a].result;
+    entry.b = m_nodes[n.b].result;
+    entry.result = std::make_shared<const CSGTree>(*entry.a,*entry.b,n.type);
+  }
+  n.result = entry.result;
+  std::lock_guard<std::mutex> guard(m_cache_mutex);
+  m_cache.emplace(n.hash,std::move(entry));
+}
+
+#endif
@@ -13,6 +13,7 @@
 #include "../../unique.h"
 
 #include <Eigen/Dense>
+#include <atomic>
 #include <list>
 #include <map>
 #include <vector>
@@ -103,6 +104,16 @@ namespace igl
           // Maps edges of offending faces to all incident offending faces
           std::vector<std::pair<TrianglesIterator, TrianglesIterator> >
               candidate_triangle_pairs;
+          // Intersection found by a worker thread: faces fa and fb intersect
+          // (over object, if constructed). Lists of these are merged into
+          // count, lIF and offending in a fixed order afterwards.
+          struct Intersection
+          {
+            Index fa;
+            Index fb;
+            CGAL::Object object;
+          };
+          typedef std::vector<Intersection> IntersectionList;
 
         public:
           RemeshSelfIntersectionsParam params;
@@ -131,27 +142,36 @@ namespace igl
           // Input:
           //   fa  index of face A in F
           //   fb  index of face B in F
-          inline void count_intersection( const Index fa, const Index fb);
-          // Helper function for box_intersect. Intersect two triangles A and B,
-          // append the intersection object (point,segment,triangle) to a running
-          // list for A and B
+          // Outputs:
+          //   hits  list of intersections found by this thread, appended
+          //     with (fa,fb)
+          inline void count_intersection(
+              const Index fa,
+              const Index fb,
+              IntersectionList & hits);
+          // Helper function for process_intersecting_boxes. Intersect two
+          // triangles A and B, append the intersection object
+          // (point,segment,triangle) to a running list for A and B
           //
           // Inputs:
           //   A  triangle in 3D
           //   B  triangle in 3D
           //   fa  index of A in F (and key into offending)
           //   fb  index of B in F (and key into offending)
+          // Outputs:
+          //   hits  list of intersections found by this thread
           // Returns true only if A intersects B
           //
           inline bool intersect(
               const Triangle_3 & A, 
               const Triangle_3 & B, 
               const Index fa,
-              const Index fb);
-          // Helper function for box_intersect. In the case where A and B have
-          // already been identified to share a vertex, then we only want to
-          // add possible segment intersections. Assumes truly duplicate
-          // triangles are not given as input
+              const Index fb,
+              IntersectionList & hits);
+          // Helper function for process_intersecting_boxes. In the case where
+          // A and B have already been identified to share a vertex, then we
+          // only want to add possible segment intersections. Assumes truly
+          // duplicate triangles are not given as input
           //
           // Inputs:
           //   A  triangle in 3D
@@ -160,6 +180,8 @@ namespace igl
           //   fb  index of B in F (and key into offending)
           //   va  index of shared vertex in A (and key into offending)
           //   vb  index of shared vertex in B (and key into offending)
+          // Outputs:
+          //   hits  list of intersections found by this thread
           //   Returns true if intersection (besides shared point)
           //
           inline bool single_shared_vertex(
@@ -168,44 +190,35 @@ namespace igl
               const Index fa,
               const Index fb,
               const Index va,
-              const Index vb);
+              const Index vb,
+              IntersectionList & hits);
           // Helper handling one direction
           inline bool single_shared_vertex(
               const Triangle_3 & A,
               const Triangle_3 & B,
               const Index fa,
               const Index fb,
-              const Index va);
-          // Helper function for box_intersect. In the case where A and B have
-          // already been identified to share two vertices, then we only want
-          // to add a possible coplanar (Triangle) intersection. Assumes truly
-          // degenerate facets are not givin as input.
+              const Index va,
+              IntersectionList & hits);
+          // Helper function for process_intersecting_boxes. In the case where
+          // A and B have already been identified to share two vertices, then
+          // we only want to add a possible coplanar (Triangle) intersection.
+          // Assumes truly degenerate facets are not givin as input.
           inline bool double_shared_vertex(
               const Triangle_3 & A,
               const Triangle_3 & B,
               const Index fa,
               const Index fb,
-              const std::vector<std::pair<Index,Index> > shared);
-    
+              const std::vector<std::pair<Index,Index> > shared,
+              IntersectionList & hits);
         public:
-          // Callback function called during box self intersections test. Means
-          // boxes a and b intersect. This method then checks if the triangles
-          // in each box intersect and if so, then processes the intersections
-          //
-          // Inputs:
-          //   a  box containing a triangle
-          //   b  box containing a triangle
-          inline void box_intersect(const Box& a, const Box& b);
+          // Check whether the triangles of each pair in
+          // candidate_triangle_pairs intersect (in parallel) and if so, then
+          // processes the intersections
           inline void process_intersecting_boxes();
-        public:
-          // Getters:
-          //const IndexList& get_lIF() const{ return lIF;}
-          static inline void box_intersect_static(
-            SelfIntersectMesh * SIM, 
-            const Box &a, 
-            const Box &b);
         private:
-          std::mutex m_offending_lock;
+          // Set when params.first_only and an intersection was found
+          std::atomic<bool> m_first_hit;
       };
     }
   }
@@ -216,8 +229,10 @@ namespace igl
 #include "mesh_to_cgal_triangle_list.h"
 #include "remesh_intersections.h"
 
+#include "../../AABB.h"
 #include "../../REDRUM.h"
 #include "../../get_seconds.h"
+#include "../../parallel_for.h"
 #include "../../C_STR.h"
 
 
@@ -226,6 +241,7 @@ namespace igl
 #include <exception>
 #include <cassert>
 #include <iostream>
+#include <type_traits>
 
 // References:
 // http://minregret.googlecode.com/svn/trunk/skyline/src/extern/CGAL-3.3.1/examples/Polyhedron/polyhedron_self_intersection.cpp
@@ -238,39 +254,6 @@ namespace igl
 // to take advantage of functions like insert_in_facet because we want to
 // constrain segments. Hmmm. Actually Triangulation_3 doesn't look right...
 
-// CGAL's box_self_intersection_d uses C-style function callbacks without
-// userdata. This is a leapfrog method for calling a member function. It should
-// be bound as if the prototype was:
-//   static void box_intersect(const Box &a, const Box &b)
-// using boost:
-//  boost::function<void(const Box &a,const Box &b)> cb
-//    = boost::bind(&::box_intersect, this, _1,_2);
-//   
-template <
-  typename Kernel,
-  typename DerivedV,
-  typename DerivedF,
-  typename DerivedVV,
-  typename DerivedFF,
-  typename DerivedIF,
-  typename DerivedJ,
-  typename DerivedIM>
-inline void igl::copyleft::cgal::SelfIntersectMesh<
-  Kernel,
-  DerivedV,
-  DerivedF,
-  DerivedVV,
-  DerivedFF,
-  DerivedIF,
-  DerivedJ,
-  DerivedIM>::box_intersect_static(
-  Self * SIM, 
-  const typename Self::Box &a, 
-  const typename Self::Box &b)
-{
-  SIM->box_intersect(a,b);
-}
-
 template <
   typename Kernel,
   typename DerivedV,
@@ -303,7 +286,8 @@ inline igl::copyleft::cgal::SelfIntersectMesh<
   T(),
   lIF(),
   offending(),
-  params(params)
+  params(params),
+  m_first_hit(false)
 {
   using namespace std;
   using namespace Eigen;
@@ -342,20 +326,70 @@ inline igl::copyleft::cgal::SelfIntersectMesh<
       boxes.push_back(Box(tit->bbox(), tit));
     }
   }
-  // Leapfrog callback
-  std::function<void(const Box &a,const Box &b)> cb = 
-    std::bind(&box_intersect_static, this, 
-      // Explicitly use std namespace to avoid confusion with boost (who puts
-      // _1 etc. in global namespace)
-      std::placeholders::_1,
-      std::placeholders::_2);
 #ifdef IGL_SELFINTERSECTMESH_DEBUG
   log_time("box_and_bind");
 #endif
-  // Run the self intersection algorithm with all defaults
-  CGAL::box_self_intersection_d(boxes.begin(), boxes.end(),cb);
+  // Collect the pairs of overlapping (closed) boxes in parallel: box b is
+  // stored as the "segment" from its min to its max corner in an AABB tree,
+  // which each box then queries independently, keeping only partners after
+  // it so that every pair is found once. Partners are merged in box order.
+  candidate_triangle_pairs.clear();
+  if(!boxes.empty())
+  {
+    const int num_boxes = boxes.size();
+    Eigen::MatrixXd BV(2*num_boxes,3);
+    Eigen::MatrixXi BE(num_boxes,2);
+    for(int b = 0;b<num_boxes;b++)
+    {
+      for(int d = 0;d<3;d++)
+      {
+        BV(b,d) = boxes[b].min_coord(d);
+        BV(num_boxes+b,d) = boxes[b].max_coord(d);
+      }
+      BE(b,0) = b;
+      BE(b,1) = num_boxes+b;
+    }
+    typedef igl::AABB<Eigen::MatrixXd,3> BoxTree;
+    BoxTree tree;
+    tree.init(BV,BE);
+    std::vector<std::vector<int> > partners(num_boxes);
+    igl::parallel_for(num_boxes,[&](const int b)
+    {
+      const Eigen::AlignedBox<double,3> query(
+        BV.row(b).transpose(),BV.row(num_boxes+b).transpose());
+      std::vector<const BoxTree *> stack(1,&tree);
+      while(!stack.empty())
+      {
+        const BoxTree * node = stack.back();
+        stack.pop_back();
+        if(!node->m_box.intersects(query))
+        {
+          continue;
+        }
+        if(node->is_leaf())
+        {
+          if(node->m_primitive > b)
+          {
+            partners[b].push_back(node->m_primitive);
+          }
+          continue;
+        }
+        stack.push_back(node->m_left);
+        stack.push_back(node->m_right);
+      }
+      std::sort(partners[b].begin(),partners[b].end());
+    },1000);
+    for(int b = 0;b<num_boxes;b++)
+    {
+      for(const int c : partners[b])
+      {
+        candidate_triangle_pairs.push_back(
+          {boxes[b].handle(), boxes[c].handle()});
+      }
+    }
+  }
 #ifdef IGL_SELFINTERSECTMESH_DEBUG
-  log_time("box_intersection_d");
+  log_time("box_intersection");
 #endif
   try{
     process_intersecting_boxes();
@@ -454,18 +488,15 @@ inline void igl::copyleft::cgal::SelfIntersectMesh<
   DerivedJ,
   DerivedIM>::count_intersection(
   const Index fa,
-  const Index fb)
+  const Index fb,
+  IntersectionList & hits)
 {
-  std::lock_guard<std::mutex> guard(m_offending_lock);
-  mark_offensive(fa);
-  mark_offensive(fb);
-  this->count++;
+  hits.push_back({fa,fb,CGAL::Object()});
   // We found the first intersection
-  if(params.first_only && this->count >= 1)
+  if(params.first_only)
   {
-    throw IGL_FIRST_HIT_EXCEPTION;
+    m_first_hit = true;
   }
-
 }
 
 template <
@@ -489,21 +520,19 @@ inline bool igl::copyleft::cgal::SelfIntersectMesh<
   const Triangle_3 & A, 
   const Triangle_3 & B, 
   const Index fa,
-  const Index fb)
+  const Index fb,
+  IntersectionList & hits)
 {
   // Determine whether there is an intersection
   if(!CGAL::do_intersect(A,B))
   {
     return false;
   }
-  count_intersection(fa,fb);
+  count_intersection(fa,fb,hits);
   if(!params.detect_only)
   {
     // Construct intersection
-    CGAL::Object result = CGAL::intersection(A,B);
-    std::lock_guard<std::mutex> guard(m_offending_lock);
-    offending[fa].push_back({fb, result});
-    offending[fb].push_back({fa, result});
+    hits.back().object = CGAL::intersection(A,B);
   }
   return true;
 }
@@ -531,13 +560,14 @@ inline bool igl::copyleft::cgal::SelfIntersectMesh<
   const Index fa,
   const Index fb,
   const Index va,
-  const Index vb)
+  const Index vb,
+  IntersectionList & hits)
 {
-  if(single_shared_vertex(A,B,fa,fb,va))
+  if(single_shared_vertex(A,B,fa,fb,va,hits))
   {
     return true;
   }
-  return single_shared_vertex(B,A,fb,fa,vb);
+  return single_shared_vertex(B,A,fb,fa,vb,hits);
 }
 
 template <
@@ -562,7 +592,8 @@ inline bool igl::copyleft::cgal::SelfIntersectMesh<
   const Triangle_3 & B,
   const Index fa,
   const Index fb,
-  const Index va)
+  const Index va,
+  IntersectionList & hits)
 {
   // This was not a good idea. It will not handle coplanar triangles well.
   using namespace std;
@@ -576,7 +607,7 @@ inline bool igl::copyleft::cgal::SelfIntersectMesh<
     // and then it will be counted twice.
     if(params.detect_only)
     {
-      count_intersection(fa,fb);
+      count_intersection(fa,fb,hits);
       return true;
     }
     CGAL::Object result = CGAL::intersection(sa,B);
@@ -586,15 +617,13 @@ inline bool igl::copyleft::cgal::SelfIntersectMesh<
       CGAL::Object seg = CGAL::make_object(Segment_3(
         A.vertex(va),
         *p));
-      count_intersection(fa,fb);
-      std::lock_guard<std::mutex> guard(m_offending_lock);
-      offending[fa].push_back({fb, seg});
-      offending[fb].push_back({fa, seg});
+      count_intersection(fa,fb,hits);
+      hits.back().object = seg;
       return true;
     }else if(CGAL::object_cast<Segment_3 >(&result))
     {
       // Need to do full test. Intersection could be a general poly.
-      bool test = intersect(A,B,fa,fb);
+      bool test = intersect(A,B,fa,fb,hits);
       ((void)test);
       assert(test && "intersect should agree with do_intersect");
       return true;
@@ -631,7 +660,8 @@ inline bool igl::copyleft::cgal::SelfIntersectMesh<
   const Triangle_3 & B,
   const Index fa,
   const Index fb,
-  const std::vector<std::pair<Index,Index> > shared)
+  const std::vector<std::pair<Index,Index> > shared,
+  IntersectionList & hits)
 {
   using namespace std;
 
@@ -690,7 +720,7 @@ inline bool igl::copyleft::cgal::SelfIntersectMesh<
   }
 
   // there is an intersection indeed
-  count_intersection(fa,fb);
+  count_intersection(fa,fb,hits);
   if(params.detect_only)
   {
     return true;
@@ -717,9 +747,7 @@ inline bool igl::copyleft::cgal::SelfIntersectMesh<
       } else
       {
         // Triangle object
-        std::lock_guard<std::mutex> guard(m_offending_lock);
-        offending[fa].push_back({fb, result});
-        offending[fb].push_back({fa, result});
+        hits.back().object = result;
         return true;
       }
     }else
@@ -744,30 +772,6 @@ inline bool igl::copyleft::cgal::SelfIntersectMesh<
   return false;
 }
 
-template <
-  typename Kernel,
-  typename DerivedV,
-  typename DerivedF,
-  typename DerivedVV,
-  typename DerivedFF,
-  typename DerivedIF,
-  typename DerivedJ,
-  typename DerivedIM>
-inline void igl::copyleft::cgal::SelfIntersectMesh<
-  Kernel,
-  DerivedV,
-  DerivedF,
-  DerivedVV,
-  DerivedFF,
-  DerivedIF,
-  DerivedJ,
-  DerivedIM>::box_intersect(
-  const Box& a, 
-  const Box& b)
-{
-  candidate_triangle_pairs.push_back({a.handle(), b.handle()});
-}
-
 template <
   typename Kernel,
   typename DerivedV,
@@ -787,44 +791,61 @@ inline void igl::copyleft::cgal::SelfIntersectMesh<
   DerivedJ,
   DerivedIM>::process_intersecting_boxes()
 {
-  std::vector<std::mutex> triangle_locks(T.size());
-  std::vector<std::mutex> vertex_locks(V.rows());
-  std::mutex index_lock;
-  std::mutex exception_mutex;
-  bool exception_fired = false;
-  int exception = -1;
-  auto process_chunk = 
-    [&](
-      const size_t first, 
-      const size_t last) -> void
+  // Lazy exact kernels (Epeck) share reference counted numbers between
+  // triangles with common vertices, and constructions add references to
+  // them: lock the triangles and vertices of each pair while testing it.
+  // Floating point kernels share nothing.
+  const bool needs_locks = 
+    !std::is_floating_point<typename Kernel::FT>::value;
+  std::vector<std::mutex> triangle_locks(needs_locks ? T.size() : 0);
+  std::vector<std::mutex> vertex_locks(needs_locks ? V.rows() : 0);
+
+  size_t num_threads=0;
+  const size_t hardware_limit = std::thread::hardware_concurrency();
+  if (const char* igl_num_threads = std::getenv("LIBIGL_NUM_THREADS")) {
+    num_threads = atoi(igl_num_threads);
+  }
+  if (num_threads == 0 || num_threads > hardware_limit) {
+    num_threads = hardware_limit;
+  }
+  num_threads = std::max(num_threads, size_t(1));
+  // Many more chunks than threads: the cost of a pair varies a lot, so
+  // threads pull chunks until none are left. Each chunk has its own list of
+  // intersections, merged in chunk order below.
+  const size_t num_pairs = candidate_triangle_pairs.size();
+  const size_t chunk_size = 
+    std::max(size_t(1), num_pairs / (16*num_threads));
+  const size_t num_chunks = (num_pairs + chunk_size - 1) / chunk_size;
+  std::vector<IntersectionList> chunk_hits(num_chunks);
+  std::atomic<size_t> next_chunk(0);
+  auto process_chunks = [&]() -> void
   {
-    try
+    while(!m_first_hit)
     {
-      assert(last >= first);
-
-      for (size_t i=first; i<last; i++) 
+      const size_t c = next_chunk++;
+      if(c >= num_chunks) return;
+      IntersectionList & hits = chunk_hits[c];
+      const size_t first = c*chunk_size;
+      const size_t last = std::min(num_pairs, first+chunk_size);
+      for (size_t i=first; i<last && !m_first_hit; i++) 
       {
-        if(exception_fired) return;
-        Index fa=T.size(), fb=T.size();
-        {
-          // Before knowing which triangles are involved, we need to lock
-          // everything to prevent race condition in updating reference
-          // counters.
-          std::lock_guard<std::mutex> guard(index_lock);
-          const auto& tri_pair = candidate_triangle_pairs[i];
-          fa = tri_pair.first - T.begin();
-          fb = tri_pair.second - T.begin();
-        }
-        assert(fa < T.size());
-        assert(fb < T.size());
-
-        // Lock triangles
-        std::lock_guard<std::mutex> guard_A(triangle_locks[fa]);
-        std::lock_guard<std::mutex> guard_B(triangle_locks[fb]);
-
-        // Lock vertices
+        const auto& tri_pair = candidate_triangle_pairs[i];
+        const Index fa = tri_pair.first - T.begin();
+        const Index fb = tri_pair.second - T.begin();
+        assert(fa < (Index)T.size());
+        assert(fb < (Index)T.size());
+
+        // Lock triangles (std::lock avoids dead locks)
+        std::unique_lock<std::mutex> guard_A, guard_B;
+        // Lock vertices (in increasing order)
         std::list<std::lock_guard<std::mutex> > guard_vertices;
+        if(needs_locks)
         {
+          guard_A = std::unique_lock<std::mutex>(
+            triangle_locks[fa], std::defer_lock);
+          guard_B = std::unique_lock<std::mutex>(
+            triangle_locks[fb], std::defer_lock);
+          std::lock(guard_A, guard_B);
           std::vector<typename DerivedF::Scalar> unique_vertices;
           std::vector<size_t> tmp1, tmp2;
           igl::unique({F(fa,0), F(fa,1), F(fa,2), F(fb,0), F(fb,1), F(fb,2)},
@@ -834,7 +855,6 @@ inline void igl::copyleft::cgal::SelfIntersectMesh<
               guard_vertices.emplace_back(vertex_locks[vi]);
               });
         }
-        if(exception_fired) return;
 
         const Triangle_3& A = T[fa];
         const Triangle_3& B = T[fb];
@@ -864,7 +884,6 @@ inline void igl::copyleft::cgal::SelfIntersectMesh<
         }
         const Index total_shared_vertices = 
           comb_shared_vertices + geo_shared_vertices;
-        if(exception_fired) return;
 
         if(comb_shared_vertices== 3)
         {
@@ -891,49 +910,54 @@ inline void igl::copyleft::cgal::SelfIntersectMesh<
           // | /\ |
           // |/  \|
           // o----o
-          double_shared_vertex(A,B,fa,fb,shared);
+          double_shared_vertex(A,B,fa,fb,shared,hits);
           continue;
         }
         assert(total_shared_vertices<=1);
         if(total_shared_vertices==1)
         {
-          single_shared_vertex(A,B,fa,fb,shared[0].first,shared[0].second);
+          single_shared_vertex(
+            A,B,fa,fb,shared[0].first,shared[0].second,hits);
         }else
         {
-          intersect(A,B,fa,fb);
+          intersect(A,B,fa,fb,hits);
         }
       }
-    }catch(int e)
-    {
-      std::lock_guard<std::mutex> exception_lock(exception_mutex);
-      exception_fired = true;
-      exception = e;
     }
   };
-  size_t num_threads=0;
-  const size_t hardware_limit = std::thread::hardware_concurrency();
-  if (const char* igl_num_threads = std::getenv("LIBIGL_NUM_THREADS")) {
-    num_threads = atoi(igl_num_threads);
-  }
-  if (num_threads == 0 || num_threads > hardware_limit) {
-    num_threads = hardware_limit;
-  }
-  assert(num_threads > 0);
-  const size_t num_pairs = candidate_triangle_pairs.size();
-  const size_t chunk_size = num_pairs / num_threads;
   std::vector<std::thread> threads;
-  for (size_t i=0; i<num_threads-1; i++) 
+  for (size_t i=0; i+1<std::min(num_threads,num_chunks); i++) 
   {
-    threads.emplace_back(process_chunk, i*chunk_size, (i+1)*chunk_size);
+    threads.emplace_back(process_chunks);
   }
   // Do some work in the master thread.
-  process_chunk((num_threads-1)*chunk_size, num_pairs);
+  process_chunks();
   for (auto& t : threads) 
   {
     if (t.joinable()) t.join();
   }
-  if(exception_fired) throw exception;
-  //process_chunk(0, candidate_triangle_pairs.size());
+
+  // Merge in the order of the candidate pairs, independent of scheduling
+  for (auto& hits : chunk_hits) 
+  {
+    for (auto& hit : hits) 
+    {
+      mark_offensive(hit.fa);
+      mark_offensive(hit.fb);
+      this->count++;
+      // We found the first intersection
+      if(params.first_only)
+      {
+        throw IGL_FIRST_HIT_EXCEPTION;
+      }
+      if(!hit.object.empty())
+      {
+        offending[hit.fa].push_back({hit.fb, hit.object});
+        offending[hit.fb].push_back({hit.fa, hit.object});
+      }
+    }
+    IntersectionList().swap(hits);
+  }
 }
 
 #endif
@@ -18,6 +18,15 @@ IGL_INLINE void igl::copyleft::cgal::assign_scalar(
   const CGAL::Epeck::FT & _cgal,
   double & d)
 {
+  // Values that are exactly representable (e.g., input coordinates, which
+  // were never involved in a construction) have a point interval: no need
+  // to evaluate the exact type.
+  const auto approx = CGAL::to_interval(_cgal);
+  if(approx.first == approx.second)
+  {
+    d = approx.first;
+    return;
+  }
   // FORCE evaluation of the exact type otherwise interval might be huge.
   const CGAL::Epeck::FT cgal = _cgal.exact();
   const auto interval = CGAL::to_interval(cgal);
@@ -33,6 +42,15 @@ IGL_INLINE void igl::copyleft::cgal::assign_scalar(
   const CGAL::Epeck::FT & _cgal,
   float& d)
 {
+  // Values that are exactly representable (e.g., input coordinates, which
+  // were never involved in a construction) have a point interval: no need
+  // to evaluate the exact type.
+  const auto approx = CGAL::to_interval(_cgal);
+  if(approx.first == approx.second && float(approx.first) == approx.first)
+  {
+    d = approx.first;
+    return;
+  }
   // FORCE evaluation of the exact type otherwise interval might be huge.
   const CGAL::Epeck::FT cgal = _cgal.exact();
   const auto interval = CGAL::to_interval(cgal);
@@ -100,6 +118,39 @@ IGL_INLINE void igl::copyleft::cgal::assign_scalar(
 
 #ifndef WIN32
 
+#if defined(CGAL_USE_BOOST_MP) && defined(CGAL_USE_GMP)
+#include <boost/multiprecision/gmp.hpp>
+#endif
+
+namespace igl
+{
+  namespace copyleft
+  {
+    namespace cgal
+    {
+      // Copy an exact rational into an mpq_class. Epeck::FT::ET is one of
+      // these types, depending on the version and configuration of CGAL.
+      inline mpq_class exact_rational_to_mpq(const mpq_class & q)
+      {
+        return q;
+      }
+#ifdef CGAL_USE_GMP
+      inline mpq_class exact_rational_to_mpq(const CGAL::Gmpq & q)
+      {
+        return mpq_class(q.mpq());
+      }
+#endif
+#if defined(CGAL_USE_BOOST_MP) && defined(CGAL_USE_GMP)
+      inline mpq_class exact_rational_to_mpq(
+        const boost::multiprecision::mpq_rational & q)
+      {
+        return mpq_class(q.backend().data());
+      }
+#endif
+    }
+  }
+}
+
 IGL_INLINE void igl::copyleft::cgal::assign_scalar(
   const CGAL::Simple_cartesian<mpq_class>::FT & cgal,
   CGAL::Simple_cartesian<mpq_class>::FT & d)
@@ -133,4 +184,21 @@ IGL_INLINE void igl::copyleft::cgal::assign_scalar(
   } while (d < float(interval.second));
 }
 
+IGL_INLINE void igl::copyleft::cgal::assign_scalar(
+  const CGAL::Epeck::FT & cgal,
+  CGAL::Simple_cartesian<mpq_class>::FT & d)
+{
+  // FORCE evaluation of the exact type and copy its value.
+  d = exact_rational_to_mpq(cgal.exact());
+}
+
+IGL_INLINE void igl::copyleft::cgal::assign_scalar(
+  const CGAL::Simple_cartesian<mpq_class>::FT & cgal,
+  CGAL::Epeck::FT & d)
+{
+  // Each of the exact rational types above can be built from an mpq_t
+  typedef CGAL::Epeck::FT::ET ET;
+  d = CGAL::Epeck::FT(ET(cgal.get_mpq_t()));
+}
+
 #endif // WIN32
@@ -63,6 +63,14 @@ namespace igl
       IGL_INLINE void assign_scalar(
         const CGAL::Simple_cartesian<mpq_class>::FT & cgal,
         float& d);
+      // Exact conversions between lazy and plain rationals. The result
+      // shares no (reference counted) state with the input.
+      IGL_INLINE void assign_scalar(
+        const CGAL::Epeck::FT & cgal,
+        CGAL::Simple_cartesian<mpq_class>::FT & d);
+      IGL_INLINE void assign_scalar(
+        const CGAL::Simple_cartesian<mpq_class>::FT & cgal,
+        CGAL::Epeck::FT & d);
 #endif // WIN32
 
     }
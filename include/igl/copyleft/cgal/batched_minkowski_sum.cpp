@@ -0,0 +1,167 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+// 
+// Copyright (C) 2026 agent
+// 
+// This Source Code Form is subject to the terms of the Mozilla Public License 
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can 
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "batched_minkowski_sum.h"
+#include "assign.h"
+#include "assign_scalar.h"
+#include "mesh_boolean.h"
+#include "minkowski_sum.h"
+#include "../../parallel_for.h"
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+#include <cassert>
+#include <limits>
+#include <utility>
+#include <vector>
+
+template <
+  typename DerivedVA,
+  typename DerivedFA,
+  typename DerivedS,
+  typename DerivedD,
+  typename DerivedW,
+  typename DerivedG,
+  typename DerivedJ>
+IGL_INLINE void igl::copyleft::cgal::batched_minkowski_sum(
+  const Eigen::MatrixBase<DerivedVA> & VA,
+  const Eigen::MatrixBase<DerivedFA> & FA,
+  const Eigen::MatrixBase<DerivedS> & S,
+  const Eigen::MatrixBase<DerivedD> & D,
+  Eigen::PlainObjectBase<DerivedW> & W,
+  Eigen::PlainObjectBase<DerivedG> & G,
+  Eigen::PlainObjectBase<DerivedJ> & J)
+{
+  typedef CGAL::Epeck::FT ExactScalar;
+  typedef Eigen::Matrix<ExactScalar,Eigen::Dynamic,3> MatrixX3E;
+  assert(VA.cols() == 3 && "VA should be #VA by 3");
+  assert(FA.cols() == 3 && "FA must contain a closed triangle mesh");
+  assert(S.cols() == 3 && D.cols() == 3 && "S and D should be #S by 3");
+  assert(S.rows() == D.rows() && "S and D should have the same size");
+  const int num_segments = S.rows();
+  if(num_segments == 0 || FA.rows() == 0)
+  {
+    W.resize(0,3);
+    G.resize(0,3);
+    J.resize(0,2);
+    return;
+  }
+
+  const Eigen::MatrixXi FAi = FA.template cast<int>();
+
+  // Lazy exact numbers are reference counted expression DAGs that must not be
+  // touched from several threads at once. Each thread converts VA to exact
+  // once and builds its pieces from its own copy. Each piece is then
+  // rebuilt from its exact (mpq_class) values, so that no two pieces share
+  // lazy numbers and unions of distinct pieces can run in parallel.
+#ifdef WIN32
+  // No mpq_class to rebuild pieces from: run serially
+  const size_t min_parallel = std::numeric_limits<size_t>::max();
+  const auto detach = [](MatrixX3E &){};
+#else
+  const size_t min_parallel = 2;
+  const auto detach = [](MatrixX3E & X)
+  {
+    for(int i = 0;i<X.rows();i++)
+    {
+      for(int j = 0;j<3;j++)
+      {
+        CGAL::Simple_cartesian<mpq_class>::FT q;
+        assign_scalar(X(i,j),q);
+        assign_scalar(q,X(i,j));
+      }
+    }
+  };
+#endif
+
+  // Swept piece of each segment (not self-unioned)
+  std::vector<MatrixX3E> vW(num_segments);
+  std::vector<Eigen::MatrixXi> vG(num_segments);
+  std::vector<Eigen::MatrixXi> vJ(num_segments);
+  std::vector<MatrixX3E> thread_VAe;
+  igl::parallel_for(
+    num_segments,
+    [&thread_VAe](const size_t nthreads){ thread_VAe.resize(nthreads); },
+    [&](const int e, const size_t t)
+    {
+      if(thread_VAe[t].rows() == 0)
+      {
+        thread_VAe[t] = VA.template cast<ExactScalar>();
+      }
+      const Eigen::RowVector3d s = S.row(e).template cast<double>();
+      const Eigen::RowVector3d d = D.row(e).template cast<double>();
+      Eigen::VectorXi eJ;
+      minkowski_sum(thread_VAe[t],FAi,s,d,false,vW[e],vG[e],eJ);
+      detach(vW[e]);
+      vJ[e].resize(eJ.rows(),2);
+      vJ[e].col(0) = eJ;
+      vJ[e].col(1).setConstant(e);
+    },
+    [](const size_t){},
+    min_parallel);
+  thread_VAe.clear();
+
+  // Balanced reduction: union neighboring pieces, level by level. Each
+  // union also resolves the self-overlaps of its operands. The unions of a
+  // level have disjoint operands (whose results share no lazy numbers with
+  // other unions' results), so they run in parallel.
+  bool resolved = false;
+  while(vW.size() > 1)
+  {
+    const int n = vW.size();
+    const int half = n/2;
+    std::vector<MatrixX3E> nW((n+1)/2);
+    std::vector<Eigen::MatrixXi> nG((n+1)/2);
+    std::vector<Eigen::MatrixXi> nJ((n+1)/2);
+    igl::parallel_for(half,[&](const int k)
+    {
+      const int a = 2*k;
+      const int b = 2*k+1;
+      Eigen::VectorXi SJ;
+      mesh_boolean(
+        vW[a],vG[a],vW[b],vG[b],MESH_BOOLEAN_TYPE_UNION,nW[k],nG[k],SJ);
+      // SJ indexes [vG[a];vG[b]]
+      nJ[k].resize(SJ.rows(),2);
+      for(int g = 0;g<SJ.rows();g++)
+      {
+        nJ[k].row(g) = SJ(g) < vG[a].rows() ?
+          vJ[a].row(SJ(g)) : vJ[b].row(SJ(g)-vG[a].rows());
+      }
+    },min_parallel);
+    if(n % 2 == 1)
+    {
+      // Carry the odd piece to the next level
+      nW.back() = std::move(vW.back());
+      nG.back() = std::move(vG.back());
+      nJ.back() = std::move(vJ.back());
+    }
+    vW = std::move(nW);
+    vG = std::move(nG);
+    vJ = std::move(nJ);
+    resolved = true;
+  }
+  if(!resolved)
+  {
+    // Single segment: resolve self-overlaps
+    Eigen::VectorXi SJ;
+    mesh_boolean(
+      MatrixX3E(vW[0]),Eigen::MatrixXi(vG[0]),MatrixX3E(),Eigen::MatrixXi(0,3),
+      MESH_BOOLEAN_TYPE_UNION,vW[0],vG[0],SJ);
+    Eigen::MatrixXi J0(SJ.rows(),2);
+    for(int g = 0;g<SJ.rows();g++)
+    {
+      J0.row(g) = vJ[0].row(SJ(g));
+    }
+    vJ[0] = J0;
+  }
+  assign(vW[0],W);
+  G = vG[0].template cast<typename DerivedG::Scalar>();
+  J = vJ[0].template cast<typename DerivedJ::Scalar>();
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::copyleft::cgal::batched_minkowski_sum<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+#endif
@@ -0,0 +1,64 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+// 
+// Copyright (C) 2026 agent
+// 
+// This Source Code Form is subject to the terms of the Mozilla Public License 
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can 
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_COPYLEFT_CGAL_BATCHED_MINKOWSKI_SUM_H
+#define IGL_COPYLEFT_CGAL_BATCHED_MINKOWSKI_SUM_H
+
+#include "../../igl_inline.h"
+#include <Eigen/Core>
+
+namespace igl
+{
+  namespace copyleft
+  {
+    namespace cgal
+    {
+      // Compute the union of the Minkowski sums of a closed triangle mesh
+      // (VA,FA) (e.g., a tool) with each of a batch of segments (e.g., a tool
+      // path). The mesh is converted to exact numbers once per thread and
+      // shared by the segments of that thread. The (unresolved) swept pieces
+      // of the segments are computed in parallel and merged by a balanced
+      // binary tree of mesh_boolean unions, so that each union has operands
+      // of similar size; the unions of each level run in parallel.
+      //
+      // Inputs:
+      //   VA  #VA by 3 list of mesh vertices in 3D
+      //   FA  #FA by 3 list of triangle indices into VA
+      //   S  #S by 3 list of segment source endpoints
+      //   D  #S by 3 list of segment destination endpoints
+      // Outputs:
+      //   W  #W by 3 list of mesh vertices in 3D
+      //   G  #G by 3 list of triangle indices into W
+      //   J  #G by 2 list of birth parents: J(g,0) indexes [FA;#FA+FA;2*#FA+1]
+      //     as J of minkowski_sum for segment J(g,1)
+      //
+      // See also: minkowski_sum
+      template <
+        typename DerivedVA,
+        typename DerivedFA,
+        typename DerivedS,
+        typename DerivedD,
+        typename DerivedW,
+        typename DerivedG,
+        typename DerivedJ>
+      IGL_INLINE void batched_minkowski_sum(
+        const Eigen::MatrixBase<DerivedVA> & VA,
+        const Eigen::MatrixBase<DerivedFA> & FA,
+        const Eigen::MatrixBase<DerivedS> & S,
+        const Eigen::MatrixBase<DerivedD> & D,
+        Eigen::PlainObjectBase<DerivedW> & W,
+        Eigen::PlainObjectBase<DerivedG> & G,
+        Eigen::PlainObjectBase<DerivedJ> & J);
+    }
+  }
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "batched_minkowski_sum.cpp"
+#endif
+
+#endif
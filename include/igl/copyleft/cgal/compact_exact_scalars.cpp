@@ -0,0 +1,43 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+// 
+// Copyright (C) 2026 agent
+// 
+// This Source Code Form is subject to the terms of the Mozilla Public License 
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can 
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "compact_exact_scalars.h"
+#include <algorithm>
+#include <utility>
+
+template <typename DerivedV>
+IGL_INLINE void igl::copyleft::cgal::compact_exact_scalars(
+  const int first_row,
+  const bool force_exact,
+  Eigen::PlainObjectBase<DerivedV> & V)
+{
+  typedef typename DerivedV::Scalar ExactScalar;
+  // Serial: entries may share construction histories, whose evaluation is
+  // not thread safe
+  for(int i = std::max(first_row,0);i<V.rows();i++)
+  {
+    for(int j = 0;j<V.cols();j++)
+    {
+      ExactScalar & x = V(i,j);
+      const std::pair<double,double> interval = CGAL::to_interval(x);
+      if(interval.first == interval.second)
+      {
+        x = ExactScalar(interval.first);
+      }else if(force_exact)
+      {
+        x = ExactScalar(x.exact());
+      }
+    }
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::copyleft::cgal::compact_exact_scalars<Eigen::Matrix<CGAL::Epeck::FT, -1, -1, 0, -1, -1> >(const int, const bool, Eigen::PlainObjectBase<Eigen::Matrix<CGAL::Epeck::FT, -1, -1, 0, -1, -1> >&);
+template void igl::copyleft::cgal::compact_exact_scalars<Eigen::Matrix<CGAL::Epeck::FT, -1, -1, 1, -1, -1> >(const int, const bool, Eigen::PlainObjectBase<Eigen::Matrix<CGAL::Epeck::FT, -1, -1, 1, -1, -1> >&);
+template void igl::copyleft::cgal::compact_exact_scalars<Eigen::Matrix<CGAL::Epeck::FT, -1, 3, 0, -1, 3> >(const int, const bool, Eigen::PlainObjectBase<Eigen::Matrix<CGAL::Epeck::FT, -1, 3, 0, -1, 3> >&);
+#endif
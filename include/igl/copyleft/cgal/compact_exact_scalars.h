@@ -0,0 +1,51 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+// 
+// Copyright (C) 2026 agent
+// 
+// This Source Code Form is subject to the terms of the Mozilla Public License 
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can 
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_COPYLEFT_CGAL_COMPACT_EXACT_SCALARS_H
+#define IGL_COPYLEFT_CGAL_COMPACT_EXACT_SCALARS_H
+#include "../../igl_inline.h"
+#include <Eigen/Core>
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+
+namespace igl
+{
+  namespace copyleft
+  {
+    namespace cgal
+    {
+      // Reduce the memory held by a matrix of lazy exact numbers (e.g.,
+      // vertices constructed by remesh_self_intersections), without changing
+      // any value. Each constructed lazy number keeps its construction
+      // history (a reference counted DAG of the primitives it was built
+      // from) alive until its exact value is computed. Entries whose value
+      // is a double (i.e., whose interval approximation is a single point)
+      // are replaced by a plain double leaf; optionally, all other entries
+      // are evaluated exactly and replaced by a leaf holding only their
+      // rational value.
+      //
+      // Inputs:
+      //   first_row  index of first row to compact: rows before it (e.g.,
+      //     input vertices, which are leaves already shared with the caller's
+      //     input) are left untouched
+      //   force_exact  whether to also evaluate and compact entries that are
+      //     not doubles (slower, but drops all construction histories)
+      //   V  #V by #dim matrix of lazy exact numbers
+      // Outputs:
+      //   V  #V by #dim matrix of the same values
+      template <typename DerivedV>
+      IGL_INLINE void compact_exact_scalars(
+        const int first_row,
+        const bool force_exact,
+        Eigen::PlainObjectBase<DerivedV> & V);
+    }
+  }
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "compact_exact_scalars.cpp"
+#endif
+#endif
@@ -9,6 +9,7 @@
 #define IGL_COPYLEFT_CGAL_CONVEX_HULL_H
 #include "../../igl_inline.h"
 #include <Eigen/Core>
+#include <vector>
 
 namespace igl
 {
@@ -45,6 +46,23 @@ namespace igl
       IGL_INLINE void convex_hull(
         const Eigen::MatrixBase<DerivedV> & V,
         Eigen::PlainObjectBase<DerivedF> & F);
+      // Given a batch of point sets (Vs), compute their convex hulls in
+      // parallel
+      //
+      // Inputs:
+      //   Vs  #Vs list of #V by 3 lists of input points
+      // Outputs:
+      //   Ws  #Vs list of #W by 3 lists of convex hull points
+      //   Gs  #Vs list of #G by 3 lists of triangle indices into Ws
+      //
+      template <
+        typename DerivedV,
+        typename DerivedW,
+        typename DerivedG>
+      IGL_INLINE void convex_hull(
+        const std::vector<DerivedV> & Vs,
+        std::vector<DerivedW> & Ws,
+        std::vector<DerivedG> & Gs);
     }
   }
 }
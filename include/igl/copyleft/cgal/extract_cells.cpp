@@ -7,6 +7,7 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 //
 #include "extract_cells.h"
+#include "assign_scalar.h"
 #include "closest_facet.h"
 #include "order_facets_around_edge.h"
 #include "outer_facet.h"
@@ -14,6 +15,7 @@
 #include "../../extract_manifold_patches.h"
 #include "../../facet_components.h"
 #include "../../get_seconds.h"
+#include "../../parallel_for.h"
 #include "../../triangle_triangle_adjacency.h"
 #include "../../unique_edge_map.h"
 #include "../../vertex_triangle_adjacency.h"
@@ -25,12 +27,121 @@
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
 
 #include <iostream>
+#include <limits>
 #include <vector>
 #include <queue>
 #include <map>
 #include <set>
+#include <type_traits>
+#include <utility>
 
 //#define EXTRACT_CELLS_DEBUG
+// Print the time spent in each stage
+//#define EXTRACT_CELLS_TIMING
+
+namespace igl
+{
+  namespace copyleft
+  {
+    namespace cgal
+    {
+      namespace extract_cells_helper
+      {
+        // Lazy exact numbers are reference counted expression DAGs that must
+        // not be touched from several threads. Vertices are instead copied
+        // serially into plain values (mpq_class), from which each thread
+        // builds its own exact numbers (see remesh_intersections).
+#ifdef WIN32
+        // No mpq_class: copies would share lazy numbers, so run serially
+        const size_t min_parallel = std::numeric_limits<size_t>::max();
+        inline const CGAL::Epeck::FT & to_value(const CGAL::Epeck::FT & x)
+        {
+          return x;
+        }
+        inline void from_value(
+          const CGAL::Epeck::FT & q, CGAL::Epeck::FT & x)
+        {
+          x = q;
+        }
+#else
+        const size_t min_parallel = 2;
+        inline mpq_class to_value(const CGAL::Epeck::FT & x)
+        {
+          // Coordinates that are doubles need no exact evaluation
+          const std::pair<double,double> interval = CGAL::to_interval(x);
+          if(interval.first == interval.second)
+          {
+            return mpq_class(interval.first);
+          }
+          mpq_class q;
+          assign_scalar(x,q);
+          return q;
+        }
+        inline void from_value(const mpq_class & q, CGAL::Epeck::FT & x)
+        {
+          assign_scalar(q,x);
+        }
+#endif
+        inline double to_value(const double x)
+        {
+          return x;
+        }
+        inline void from_value(const double q, double & x)
+        {
+          x = q;
+        }
+
+        // Value copy of (some rows of) a #V by 3 matrix of vertex positions
+        template <typename DerivedV>
+        struct ValueVertices
+        {
+          typedef typename std::decay<decltype(
+            to_value(std::declval<typename DerivedV::Scalar>()))>::type
+            Scalar;
+          std::vector<Scalar> values;
+          // Copy row v of V (serially)
+          void copy(const Eigen::PlainObjectBase<DerivedV> & V,const size_t v)
+          {
+            if(values.empty())
+            {
+              values.resize(3*V.rows());
+            }
+            for(size_t j = 0;j<3;j++)
+            {
+              values[3*v+j] = to_value(V(v,j));
+            }
+          }
+        };
+
+        // Exact vertex positions private to one thread, whose rows are built
+        // on demand from a value copy
+        template <typename DerivedV>
+        struct ThreadVertices
+        {
+          DerivedV V;
+          std::vector<char> built;
+          void build(const ValueVertices<DerivedV> & VQ, const size_t v)
+          {
+            if(built.empty())
+            {
+              V.resize(VQ.values.size()/3,3);
+              built.resize(V.rows(),0);
+            }
+            if(built[v])
+            {
+              return;
+            }
+            for(size_t j = 0;j<3;j++)
+            {
+              from_value(VQ.values[3*v+j],V(v,j));
+            }
+            built[v] = 1;
+          }
+        };
+      }
+    }
+  }
+}
 
 template<
   typename DerivedV,
@@ -101,7 +212,7 @@ IGL_INLINE size_t igl::copyleft::cgal::extract_cells(
   typedef CGAL::AABB_traits<Kernel, Primitive> AABB_triangle_traits;
   typedef CGAL::AABB_tree<AABB_triangle_traits> Tree;
 
-#ifdef EXTRACT_CELLS_DEBUG
+#if defined(EXTRACT_CELLS_DEBUG) || defined(EXTRACT_CELLS_TIMING)
   const auto & tictoc = []() -> double
   {
     static double t_start = igl::get_seconds();
@@ -152,42 +263,70 @@ IGL_INLINE size_t igl::copyleft::cgal::extract_cells(
   std::vector<std::vector<size_t> > VF,VFi;
   igl::vertex_triangle_adjacency(V.rows(), F, VF, VFi);
   std::vector<Eigen::VectorXi> Is(num_components);
-  std::vector<
-    CGAL::AABB_tree<
-      CGAL::AABB_traits<
-        Kernel, 
-        CGAL::AABB_triangle_primitive<
-          Kernel, std::vector<
-            Kernel::Triangle_3 >::iterator > > > > trees(num_components);
-  std::vector< std::vector<Kernel::Triangle_3 > > 
-    triangle_lists(num_components);
-  std::vector<std::vector<bool> > in_Is(num_components);
-
-  // Find outer facets, their orientations and cells for each component
+  for (size_t i=0; i<num_components; i++)
+  {
+    Is[i].resize(components[i].size());
+    std::copy(components[i].begin(), components[i].end(),Is[i].data());
+  }
+
+  // Components are processed in parallel, each thread on its own exact copy
+  // of the vertices it needs (see extract_cells_helper)
+  using namespace extract_cells_helper;
+  ValueVertices<DerivedV> VQ;
+  for (size_t i=0; i<num_faces; i++)
+  {
+    for (size_t j=0; j<3; j++)
+    {
+      VQ.copy(V,F(i,j));
+    }
+  }
+  std::vector<ThreadVertices<DerivedV> > thread_V;
+  const auto prep_thread_V = [&thread_V](const size_t n)
+  {
+    thread_V.resize(std::max(thread_V.size(),n));
+  };
+  const auto no_accum = [](const size_t){};
+  // Build the vertices of faces F(I,:) in the copy of thread t
+  const auto build_faces = [&](const size_t t, const Eigen::VectorXi & I)
+  {
+    for (Eigen::Index k=0; k<I.size(); k++)
+    {
+      for (size_t j=0; j<3; j++)
+      {
+        thread_V[t].build(VQ,F(I(k),j));
+      }
+    }
+  };
+  log_time("copy_vertices");
+
+  // Find outer facets, their orientations and cells for each component.
   Eigen::VectorXi outer_facets(num_components);
   Eigen::VectorXi outer_facet_orientation(num_components);
   Eigen::VectorXi outer_cells(num_components);
+  igl::parallel_for(num_components,prep_thread_V,
+    [&](const size_t i, const size_t t)
+    {
+      build_faces(t,Is[i]);
+      bool flipped;
+      igl::copyleft::cgal::outer_facet(
+        thread_V[t].V, F, Is[i], outer_facets[i], flipped);
+      outer_facet_orientation[i] = flipped?1:0;
+    },no_accum,min_parallel);
   for (size_t i=0; i<num_components; i++)
   {
-    Is[i].resize(components[i].size());
-    std::copy(components[i].begin(), components[i].end(),Is[i].data());
-    bool flipped;
-    igl::copyleft::cgal::outer_facet(V, F, Is[i], outer_facets[i], flipped);
-    outer_facet_orientation[i] = flipped?1:0;
     outer_cells[i] = raw_cells(P[outer_facets[i]], outer_facet_orientation[i]);
   }
-#ifdef EXTRACT_CELLS_DEBUG
   log_time("outer_facet_per_component");
-#endif
 
-  // Compute barycenter of a triangle in mesh (V,F)
+  // Compute barycenter of a triangle in mesh (U,F)
   //
   // Inputs:
+  //   U  #V by 3 list of vertex positions
   //   fid  index into F
   // Returns row-vector of barycenter coordinates
-  const auto get_triangle_center = [&V,&F](const size_t fid) 
+  const auto get_triangle_center = [&F](const DerivedV & U, const size_t fid)
   {
-    return ((V.row(F(fid,0))+V.row(F(fid,1))+V.row(F(fid,2)))/3.0).eval();
+    return ((U.row(F(fid,0))+U.row(F(fid,1))+U.row(F(fid,2)))/3.0).eval();
   };
   std::vector<std::vector<size_t> > nested_cells(num_raw_cells);
   std::vector<std::vector<size_t> > ambient_cells(num_raw_cells);
@@ -228,8 +367,13 @@ IGL_INLINE size_t igl::copyleft::cgal::extract_cells(
         bbox_max(cj,2) < bbox_min(ci,2));
     };
     
-    // Loop over components. This section is O(m²)
-    for (size_t i=0; i<num_components; i++)
+    // Loop over components. This section is O(m²). Each component i lists
+    // the (candidate component, ambient cell) pairs it contains, merged in
+    // component order below.
+    std::vector<std::vector<std::pair<size_t,size_t> > >
+      contained(num_components);
+    igl::parallel_for(num_components,prep_thread_V,
+      [&](const size_t i, const size_t t)
     {
       // List of components that could overlap with component i
       std::vector<size_t> candidate_comps;
@@ -242,10 +386,16 @@ IGL_INLINE size_t igl::copyleft::cgal::extract_cells(
       }
 
       const size_t num_candidate_comps = candidate_comps.size();
-      if (num_candidate_comps == 0) continue;
+      if (num_candidate_comps == 0) return;
 
       // Build aabb tree for this component.
-      submesh_aabb_tree(V,F,Is[i],trees[i],triangle_lists[i],in_Is[i]);
+      build_faces(t,Is[i]);
+      const DerivedV & U = thread_V[t].V;
+      const auto& I = Is[i];
+      Tree tree;
+      std::vector<Triangle> triangles;
+      std::vector<bool> in_I;
+      submesh_aabb_tree(U,F,I,tree,triangles,in_I);
 
       // Get query points on each candidate component: barycenter of
       // outer-facet 
@@ -253,19 +403,18 @@ IGL_INLINE size_t igl::copyleft::cgal::extract_cells(
       for (size_t j=0; j<num_candidate_comps; j++)
       {
         const size_t index = candidate_comps[j];
-        queries.row(j) = get_triangle_center(outer_facets[index]);
+        for (size_t k=0; k<3; k++)
+        {
+          thread_V[t].build(VQ,F(outer_facets[index],k));
+        }
+        queries.row(j) = get_triangle_center(U,outer_facets[index]);
       }
 
       // Gather closest facets in ith component to each query point and their
       // orientations
-      const auto& I = Is[i];
-      const auto& tree = trees[i];
-      const auto& in_I = in_Is[i];
-      const auto& triangles = triangle_lists[i];
-
       Eigen::VectorXi closest_facets, closest_facet_orientations;
       closest_facet(
-        V,
+        U,
         F, 
         I, 
         queries,
@@ -293,17 +442,24 @@ IGL_INLINE size_t igl::copyleft::cgal::extract_cells(
           // closest facet on i to component index is **not** the same as the
           // "outer cell" of component i: component index is **not** outside of
           // component i (therefore it's inside).
-          nested_cells[ambient_cell].push_back(outer_cells[index]);
-          ambient_cells[outer_cells[index]].push_back(ambient_cell);
-          ambient_comps[index].push_back(i);
+          contained[i].emplace_back(index,ambient_cell);
         }
       }
+    },no_accum,min_parallel);
+    for (size_t i=0; i<num_components; i++)
+    {
+      for (const auto & entry : contained[i])
+      {
+        const size_t index = entry.first;
+        const size_t ambient_cell = entry.second;
+        nested_cells[ambient_cell].push_back(outer_cells[index]);
+        ambient_cells[outer_cells[index]].push_back(ambient_cell);
+        ambient_comps[index].push_back(i);
+      }
     }
   }
 
-#ifdef EXTRACT_CELLS_DEBUG
     log_time("nested_relationship");
-#endif
 
     const size_t INVALID = std::numeric_limits<size_t>::max();
     const size_t INFINITE_CELL = num_raw_cells;
@@ -369,9 +525,7 @@ IGL_INLINE size_t igl::copyleft::cgal::extract_cells(
         raw_cells(i, 1) = negative_cell_id;
     }
     cells = raw_cells;
-#ifdef EXTRACT_CELLS_DEBUG
     log_time("finalize");
-#endif
     return count;
 }
 
@@ -455,48 +609,73 @@ IGL_INLINE size_t igl::copyleft::cgal::extract_cells_single_component(
   std::vector<std::set<size_t> > equivalent_cells(num_patches*2);
   std::vector<bool> processed(num_unique_edges, false);
 
-  size_t label_count=0;
+  // Non-manifold edges between patches, in the order they are first met
+  std::vector<size_t> patch_edges;
   for (size_t i=0; i<num_patches; i++) {
     for (const auto& entry : patch_adj[i]) {
-      const size_t neighbor_patch = entry.first;
       const size_t uei = entry.second;
       if (processed[uei]) continue;
       processed[uei] = true;
-
+      patch_edges.push_back(uei);
+    }
+  }
+  const size_t num_patch_edges = patch_edges.size();
+
+  // Sort adjacent faces cyclically around each edge {s,d} in parallel, each
+  // thread on its own exact copy of the vertices it needs (see
+  // extract_cells_helper)
+  using namespace extract_cells_helper;
+  ValueVertices<DerivedV> VQ;
+  for (const size_t uei : patch_edges) {
+    for (const auto ej : uE2E[uei]) {
+      for (size_t j=0; j<3; j++) {
+        VQ.copy(V,F(edge_index_to_face_index(ej),j));
+      }
+    }
+  }
+  std::vector<std::vector<int> > signed_adj_faces(num_patch_edges);
+  std::vector<Eigen::VectorXi> orders(num_patch_edges);
+  std::vector<ThreadVertices<DerivedV> > thread_V;
+  igl::parallel_for(num_patch_edges,
+    [&thread_V](const size_t n){ thread_V.resize(n); },
+    [&](const size_t e, const size_t t) {
+      const size_t uei = patch_edges[e];
       const auto& adj_faces = uE2E[uei];
-      const size_t num_adj_faces = adj_faces.size();
-      assert(num_adj_faces > 2);
-
+      assert(adj_faces.size() > 2);
       const size_t s = uE(uei,0);
       const size_t d = uE(uei,1);
-
-      std::vector<int> signed_adj_faces;
       for (auto ej : adj_faces)
       {
         const size_t fid = edge_index_to_face_index(ej);
         bool cons = is_consistent(fid, s, d);
-        signed_adj_faces.push_back((fid+1)*(cons ? 1:-1));
-      }
-      {
-        // Sort adjacent faces cyclically around {s,d}
-        Eigen::VectorXi order;
-        // order[f] will reveal the order of face f in signed_adj_faces
-        order_facets_around_edge(V, F, s, d, signed_adj_faces, order);
-        for (size_t j=0; j<num_adj_faces; j++) {
-          const size_t curr_idx = j;
-          const size_t next_idx = (j+1)%num_adj_faces;
-          const size_t curr_patch_idx =
-            P[edge_index_to_face_index(adj_faces[order[curr_idx]])];
-          const size_t next_patch_idx =
-            P[edge_index_to_face_index(adj_faces[order[next_idx]])];
-          const bool curr_cons = signed_adj_faces[order[curr_idx]] > 0;
-          const bool next_cons = signed_adj_faces[order[next_idx]] > 0;
-          const size_t curr_cell_idx = curr_patch_idx*2 + (curr_cons?0:1);
-          const size_t next_cell_idx = next_patch_idx*2 + (next_cons?1:0);
-          equivalent_cells[curr_cell_idx].insert(next_cell_idx);
-          equivalent_cells[next_cell_idx].insert(curr_cell_idx);
+        signed_adj_faces[e].push_back((fid+1)*(cons ? 1:-1));
+        for (size_t j=0; j<3; j++) {
+          thread_V[t].build(VQ,F(fid,j));
         }
       }
+      // order[f] will reveal the order of face f in signed_adj_faces
+      order_facets_around_edge(
+        thread_V[t].V, F, s, d, signed_adj_faces[e], orders[e]);
+    },[](const size_t){},min_parallel);
+
+  // Merge in edge order
+  for (size_t e=0; e<num_patch_edges; e++) {
+    const auto& adj_faces = uE2E[patch_edges[e]];
+    const size_t num_adj_faces = adj_faces.size();
+    const Eigen::VectorXi & order = orders[e];
+    for (size_t j=0; j<num_adj_faces; j++) {
+      const size_t curr_idx = j;
+      const size_t next_idx = (j+1)%num_adj_faces;
+      const size_t curr_patch_idx =
+        P[edge_index_to_face_index(adj_faces[order[curr_idx]])];
+      const size_t next_patch_idx =
+        P[edge_index_to_face_index(adj_faces[order[next_idx]])];
+      const bool curr_cons = signed_adj_faces[e][order[curr_idx]] > 0;
+      const bool next_cons = signed_adj_faces[e][order[next_idx]] > 0;
+      const size_t curr_cell_idx = curr_patch_idx*2 + (curr_cons?0:1);
+      const size_t next_cell_idx = next_patch_idx*2 + (next_cons?1:0);
+      equivalent_cells[curr_cell_idx].insert(next_cell_idx);
+      equivalent_cells[next_cell_idx].insert(curr_cell_idx);
     }
   }
 
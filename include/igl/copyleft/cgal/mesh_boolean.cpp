@@ -9,6 +9,7 @@
 //
 #include "mesh_boolean.h"
 #include "assign.h"
+#include "compact_exact_scalars.h"
 #include "extract_cells.h"
 #include "mesh_boolean_type_to_funcs.h"
 #include "propagate_winding_numbers.h"
@@ -27,6 +28,7 @@
 
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
 #include <algorithm>
+#include <type_traits>
 
 //#define MESH_BOOLEAN_TIMING
 //#define DOUBLE_CHECK_EXACT_OUTPUT
@@ -213,6 +215,8 @@ IGL_INLINE bool igl::copyleft::cgal::mesh_boolean(
   MatrixXES V;
   DerivedFC F;
   VectorXJ  CJ;
+  // Input vertices come first in V (followed by constructed ones)
+  int num_input_vertices = 0;
   {
     Eigen::VectorXi I;
     igl::copyleft::cgal::RemeshSelfIntersectionsParam params;
@@ -229,7 +233,14 @@ IGL_INLINE bool igl::copyleft::cgal::mesh_boolean(
       // Remove unreferenced vertices.
       Eigen::VectorXi UIM;
       igl::remove_unreferenced(Vr, Fr, V, F, UIM);
+      for(int i = 0;i<VV.rows();i++)
+      {
+        num_input_vertices += UIM(i) >= 0;
+      }
    }
+  // Replace constructed coordinates that are doubles by plain leaves (cheap:
+  // no exact evaluation)
+  compact_exact_scalars(num_input_vertices,false,V);
 #ifdef MESH_BOOLEAN_TIMING
   log_time("resolve_self_intersection");
 #endif
@@ -401,10 +412,29 @@ IGL_INLINE bool igl::copyleft::cgal::mesh_boolean(
     }
 #endif
 
-    MatrixX3S Vs;
-    assign(V,Vs);
+    // Remove unreferenced vertices before rounding, so that only output
+    // vertices are rounded (rounding a constructed vertex forces evaluation
+    // of its exact value; input vertices are returned as is, see
+    // assign_scalar)
+    MatrixXES Vk;
     Eigen::VectorXi newIM;
-    igl::remove_unreferenced(Vs,G,VC,FC,newIM);
+    igl::remove_unreferenced(V,G,Vk,FC,newIM);
+    if(std::is_same<Scalar,ExactScalar>::value)
+    {
+      // Exact output: evaluate the kept constructed vertices and drop their
+      // construction histories, which would otherwise keep the whole
+      // remeshing alive in the caller's copy (rounded output evaluates them
+      // in assign below instead)
+      int num_kept_input_vertices = 0;
+      for(int i = 0;i<num_input_vertices;i++)
+      {
+        num_kept_input_vertices += newIM(i) >= 0;
+      }
+      compact_exact_scalars(num_kept_input_vertices,true,Vk);
+    }
+    MatrixX3S Vs;
+    assign(Vk,Vs);
+    VC = Vs;
   }
 #ifdef MESH_BOOLEAN_TIMING
   log_time("clean_up");
@@ -38,6 +38,12 @@ namespace igl
       //  Returns true if inputs induce a piecewise constant winding number
       //  field and type is valid
       //
+      //  All facets, including those that intersect no other facet, are
+      //  resolved, labeled and extracted with exact (CGAL::Epeck)
+      //  coordinates, so the cost grows with the size of the whole input,
+      //  not only with the size of the intersection. Only rounding the
+      //  output back to double is limited to the constructed vertices.
+      //
       //  See also: mesh_boolean_cork, intersect_other,
       //  remesh_self_intersections
       template <
@@ -6,16 +6,24 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "points_inside_component.h"
+#include "../../AABB.h"
 #include "../../LinSpaced.h"
+#include "../../parallel_for.h"
 #include "order_facets_around_edge.h"
 #include "assign_scalar.h"
 
+#include <Eigen/Geometry>
+
 #include <CGAL/AABB_tree.h>
 #include <CGAL/AABB_traits.h>
 #include <CGAL/AABB_triangle_primitive.h>
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/intersections.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <list>
 #include <limits>
 #include <vector>
@@ -32,10 +40,26 @@ namespace igl {
             typedef Kernel::Vector_3 Vector_3;
             typedef Kernel::Triangle_3 Triangle;
             typedef Kernel::Plane_3 Plane_3;
+            typedef Kernel::Segment_3 Segment_3;
             typedef std::vector<Triangle>::iterator Iterator;
             typedef CGAL::AABB_triangle_primitive<Kernel, Iterator> Primitive;
             typedef CGAL::AABB_traits<Kernel, Primitive> AABB_triangle_traits;
             typedef CGAL::AABB_tree<AABB_triangle_traits> Tree;
+#ifndef WIN32
+            // Lazy exact numbers share reference counted construction
+            // histories, so threads work on deep copies with value semantics
+            // instead (see remesh_intersections)
+            typedef CGAL::Simple_cartesian<mpq_class> ValueKernel;
+            typedef ValueKernel::Point_3 ValuePoint_3;
+            inline mpq_class to_value(const Kernel::FT& x) {
+                mpq_class q;
+                assign_scalar(x, q);
+                return q;
+            }
+            inline mpq_class to_value(const double x) {
+                return mpq_class(x);
+            }
+#endif
 
             template<typename DerivedF, typename DerivedI>
             void extract_adj_faces(
@@ -240,6 +264,43 @@ namespace igl {
                 }
                 return result == CGAL::NEGATIVE;
             }
+
+            // Order of points P along a Morton (Z-order) curve, so that
+            // consecutive queries visit the same parts of the AABB trees.
+            inline void spatially_sorted(
+                    const Eigen::MatrixXd& P,
+                    std::vector<size_t>& order) {
+                const size_t num_points = P.rows();
+                order.resize(num_points);
+                for (size_t i=0; i<num_points; i++) order[i] = i;
+                if (num_points == 0) return;
+                const Eigen::RowVector3d min_corner = P.colwise().minCoeff();
+                const double extent =
+                    (P.colwise().maxCoeff() - min_corner).maxCoeff();
+                const double scale = extent > 0 ? 2097151.0/extent : 0.0;
+                // Spread the lower 21 bits of x to every third bit
+                auto spread = [](std::uint64_t x) -> std::uint64_t {
+                    x &= 0x1fffff;
+                    x = (x | x << 32) & 0x1f00000000ffffull;
+                    x = (x | x << 16) & 0x1f0000ff0000ffull;
+                    x = (x | x << 8) & 0x100f00f00f00f00full;
+                    x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+                    x = (x | x << 2) & 0x1249249249249249ull;
+                    return x;
+                };
+                std::vector<std::uint64_t> codes(num_points);
+                for (size_t i=0; i<num_points; i++) {
+                    std::uint64_t code = 0;
+                    for (size_t d=0; d<3; d++) {
+                        code |= spread(std::uint64_t(
+                            (P(i,d)-min_corner(d))*scale)) << d;
+                    }
+                    codes[i] = code;
+                }
+                std::sort(order.begin(), order.end(),
+                    [&codes](size_t a, size_t b) {
+                        return codes[a] < codes[b]; });
+            }
         }
     }
   }
@@ -294,7 +355,10 @@ IGL_INLINE void igl::copyleft::cgal::points_inside_component(
 
     const size_t num_queries = P.rows();
     inside.resize(num_queries, 1);
-    for (size_t i=0; i<num_queries; i++) {
+    if (num_queries == 0) return;
+
+    // Exact classification of query i through its closest element.
+    auto classify_exactly = [&](size_t i) -> bool {
         const Point_3 query(P(i,0), P(i,1), P(i,2));
         auto projection = tree.closest_point_and_primitive(query);
         auto closest_point = projection.first;
@@ -305,24 +369,197 @@ IGL_INLINE void igl::copyleft::cgal::points_inside_component(
             case VERTEX:
                 {
                     const size_t s = F(I(fid, 0), element_index);
-                    inside(i,0) = determine_point_vertex_orientation(
+                    return determine_point_vertex_orientation(
                             V, F, I, query, s);
                 }
-                break;
             case EDGE:
                 {
                     const size_t s = F(I(fid, 0), (element_index+1)%3);
                     const size_t d = F(I(fid, 0), (element_index+2)%3);
-                    inside(i,0) = determine_point_edge_orientation(
+                    return determine_point_edge_orientation(
                             V, F, I, query, s, d);
                 }
-                break;
             case FACE:
-                inside(i,0) = determine_point_face_orientation(V, F, I, query, fid);
-                break;
+                return determine_point_face_orientation(V, F, I, query, fid);
             default:
                 throw "Unknown closest element type!";
         }
+    };
+
+    // Floating point copy of the component and queries, used to guess the
+    // closest facet of each query.
+    Eigen::MatrixXd Vd(V.rows(), 3);
+    for (size_t i=0; i<(size_t)V.rows(); i++) {
+        for (size_t j=0; j<3; j++) {
+            assign_scalar(V(i,j), Vd(i,j));
+        }
+    }
+    Eigen::MatrixXi FI(num_faces, 3);
+    for (size_t i=0; i<num_faces; i++) {
+        FI.row(i) = F.row(I(i, 0));
+    }
+    Eigen::MatrixXd Pd(num_queries, 3);
+    for (size_t i=0; i<num_queries; i++) {
+        for (size_t j=0; j<3; j++) {
+            assign_scalar(P(i,j), Pd(i,j));
+        }
+    }
+    igl::AABB<Eigen::MatrixXd, 3> float_tree;
+    float_tree.init(Vd, FI);
+
+    // Floating point guess of the closest facet of query i: if the closest
+    // point lies well inside a facet f, record f and the barycentric
+    // coordinates (lb,ld) of the closest point w.r.t. its second and third
+    // corners. Returns false if the case is not easy.
+    auto guess_closest_facet = [&](size_t i, int& f, double& lb, double& ld)
+        -> bool {
+        Eigen::RowVector3d c;
+        float_tree.squared_distance(Vd, FI, Pd.row(i), f, c);
+        const Eigen::RowVector3d a = Vd.row(FI(f,0));
+        const Eigen::RowVector3d b = Vd.row(FI(f,1));
+        const Eigen::RowVector3d d = Vd.row(FI(f,2));
+        const Eigen::RowVector3d n = (b-a).cross(d-a);
+        const double nn = n.squaredNorm();
+        if (!(nn > 0)) return false;
+        lb = n.dot((c-a).cross(d-a))/nn;
+        ld = n.dot((b-a).cross(c-a))/nn;
+        const double min_coordinate = 1e-4;
+        return lb > min_coordinate && ld > min_coordinate &&
+            1.0-lb-ld > min_coordinate;
+    };
+
+#ifdef WIN32
+    // Filtered classification of query i from a guess (f,lb,ld): snap the
+    // guessed closest point to an exact point c strictly inside f. If the
+    // segment from the query to c touches no other facet, the query is on
+    // the same side of the surface as it is of f. The test only uses exact
+    // predicates. Returns false if the case is not easy.
+    auto classify_filtered = [&](size_t i, int f, double lb, double ld,
+        bool& result) -> bool {
+        const Triangle& t = triangles[f];
+        const Point_3 closest_point = t[0] +
+            Kernel::FT(lb)*(t[1]-t[0]) + Kernel::FT(ld)*(t[2]-t[0]);
+        const Point_3 query(P(i,0), P(i,1), P(i,2));
+        std::vector<Tree::Primitive_id> hits;
+        tree.all_intersected_primitives(
+                Segment_3(query, closest_point), std::back_inserter(hits));
+        if (hits.size() != 1 || hits[0]-triangles.begin() != f) {
+            return false;
+        }
+        const auto orientation = CGAL::orientation(t[0], t[1], t[2], query);
+        if (orientation == CGAL::COPLANAR) return false;
+        result = orientation == CGAL::NEGATIVE;
+        return true;
+    };
+#else
+    // Filtered classification of query i from a guess (f,lb,ld): snap the
+    // guessed closest point to an exact point c strictly inside f. If the
+    // segment from the query to c touches no other facet, the query is on
+    // the same side of the surface as it is of f. Only exact predicates on
+    // value copies of the facets and queries are used, so queries are
+    // certified in parallel; facets near the segment are found in the
+    // floating point tree with a margin far above round off. Returns false
+    // if the case is not easy.
+    std::vector<ValuePoint_3> value_points(3*num_faces);
+    for (size_t i=0; i<num_faces; i++) {
+        for (size_t j=0; j<3; j++) {
+            const size_t v = FI(i,j);
+            value_points[3*i+j] = ValuePoint_3(
+                    to_value(V(v,0)), to_value(V(v,1)), to_value(V(v,2)));
+        }
+    }
+    const double margin = 1e-8*std::max(
+        std::max(Vd.cwiseAbs().maxCoeff(), Pd.cwiseAbs().maxCoeff()), 1.0);
+    auto classify_filtered = [&](const ValuePoint_3& query, size_t i, int f,
+        double lb, double ld, bool& result) -> bool {
+        typedef igl::AABB<Eigen::MatrixXd, 3> FloatTree;
+        const ValuePoint_3* t = &value_points[3*f];
+        const ValuePoint_3 closest_point = t[0] +
+            mpq_class(lb)*(t[1]-t[0]) + mpq_class(ld)*(t[2]-t[0]);
+        const ValueKernel::Segment_3 segment(query, closest_point);
+        const Eigen::RowVector3d a = Vd.row(FI(f,0));
+        const Eigen::RowVector3d c =
+            a + lb*(Vd.row(FI(f,1))-a) + ld*(Vd.row(FI(f,2))-a);
+        Eigen::AlignedBox<double, 3> box;
+        box.extend(c.transpose());
+        box.extend(Pd.row(i).transpose());
+        box.min().array() -= margin;
+        box.max().array() += margin;
+        std::vector<const FloatTree*> stack(1, &float_tree);
+        while (!stack.empty()) {
+            const FloatTree* node = stack.back();
+            stack.pop_back();
+            if (!node->m_box.intersects(box)) continue;
+            if (node->is_leaf()) {
+                const int g = node->m_primitive;
+                const ValuePoint_3* u = &value_points[3*g];
+                if (g != f && CGAL::do_intersect(segment,
+                        ValueKernel::Triangle_3(u[0], u[1], u[2]))) {
+                    return false;
+                }
+                continue;
+            }
+            stack.push_back(node->m_left);
+            stack.push_back(node->m_right);
+        }
+        const auto orientation = CGAL::orientation(t[0], t[1], t[2], query);
+        if (orientation == CGAL::COPLANAR) return false;
+        result = orientation == CGAL::NEGATIVE;
+        return true;
+    };
+#endif
+
+    // Guess the closest facets in parallel, then certify the guesses
+    std::vector<int> guess_facet(num_queries, -1);
+    std::vector<double> guess_lb(num_queries), guess_ld(num_queries);
+    igl::parallel_for(num_queries, [&](const size_t i) {
+        int f;
+        if (guess_closest_facet(i, f, guess_lb[i], guess_ld[i])) {
+            guess_facet[i] = f;
+        }
+    }, 1000);
+
+    std::vector<char> certified(num_queries, 0);
+#ifdef WIN32
+    for (size_t i=0; i<num_queries; i++) {
+        bool result;
+        if (guess_facet[i] >= 0 && classify_filtered(
+                i, guess_facet[i], guess_lb[i], guess_ld[i], result)) {
+            inside(i,0) = result;
+            certified[i] = 1;
+        }
+    }
+#else
+    // Value copies of the guessed queries are made serially, then certified
+    // in parallel
+    std::vector<ValuePoint_3> value_queries(num_queries);
+    for (size_t i=0; i<num_queries; i++) {
+        if (guess_facet[i] >= 0) {
+            value_queries[i] = ValuePoint_3(
+                    to_value(P(i,0)), to_value(P(i,1)), to_value(P(i,2)));
+        }
+    }
+    std::vector<char> certified_inside(num_queries, 0);
+    igl::parallel_for(num_queries, [&](const size_t i) {
+        bool result;
+        if (guess_facet[i] >= 0 && classify_filtered(value_queries[i],
+                i, guess_facet[i], guess_lb[i], guess_ld[i], result)) {
+            certified_inside[i] = result;
+            certified[i] = 1;
+        }
+    }, 100);
+    for (size_t i=0; i<num_queries; i++) {
+        if (certified[i]) inside(i,0) = certified_inside[i];
+    }
+#endif
+
+    // Queries that the filter could not certify go through the exact path
+    // serially, in spatial order so that consecutive queries visit the same
+    // parts of the exact tree.
+    std::vector<size_t> order;
+    spatially_sorted(Pd, order);
+    for (const size_t i : order) {
+        if (!certified[i]) inside(i,0) = classify_exactly(i);
     }
 }
 
@@ -27,6 +27,19 @@ namespace igl
       // non-degenerated surface.  Queries points must be either inside or
       // outside of the mesh (i.e. not on the surface of the mesh).
       //
+      // Queries are processed as one batch. A floating point closest facet
+      // search runs in parallel; its guesses are then certified in parallel
+      // with exact predicates on plain rational copies of the component.
+      // Only the remaining queries (e.g., closest to an edge or vertex) go
+      // through the exact closest element search, serially and in spatial
+      // order.
+      //
+      // closest_facet does not take this path: it must return the exact
+      // closest facet (ties at edges and vertices are resolved with
+      // order_facets_around_edge), and extract_cells calls it with only one
+      // query per component. peel_winding_number_layers classifies no
+      // points: its winding numbers come from propagate_winding_numbers.
+      //
       // Inputs:
       //   V  #V by 3 array of vertex positions.
       //   F  #F by 3 array of triangles.
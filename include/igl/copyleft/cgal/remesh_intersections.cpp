@@ -19,9 +19,128 @@
 #include <queue>
 #include <unordered_map>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <type_traits>
 
 //#define REMESH_INTERSECTIONS_TIMING
 
+namespace igl
+{
+  namespace copyleft
+  {
+    namespace cgal
+    {
+      // Kernel in which the constrained Delaunay triangulations are computed.
+      // Plain floating point kernels share no state between objects, so each
+      // triangulation can run on its own thread directly.
+      template <
+        typename Kernel,
+        bool is_lazy =
+          std::is_same<typename Kernel::FT,CGAL::Epeck::FT>::value>
+      struct RemeshIntersectionsCDTKernel
+      {
+        typedef Kernel type;
+        static const bool thread_safe =
+          std::is_floating_point<typename Kernel::FT>::value;
+        static const CGAL::Point_3<type> & to(const CGAL::Point_3<Kernel> & p)
+        {
+          return p;
+        }
+        static const CGAL::Plane_3<type> & to(const CGAL::Plane_3<Kernel> & P)
+        {
+          return P;
+        }
+        static const CGAL::Point_3<Kernel> & from(const CGAL::Point_3<type> & p)
+        {
+          return p;
+        }
+      };
+#ifndef WIN32
+      // Lazy exact numbers are reference counted expression DAGs shared by
+      // all objects constructed from the same input (and evaluated lazily),
+      // so they must not be touched from several threads. Instead each
+      // triangulation gets deep copies with value semantics (mpq_class),
+      // converted serially before and after.
+      template <typename Kernel>
+      struct RemeshIntersectionsCDTKernel<Kernel,true>
+      {
+        typedef CGAL::Simple_cartesian<mpq_class> type;
+        static const bool thread_safe = true;
+        static CGAL::Point_3<type> to(const CGAL::Point_3<Kernel> & p)
+        {
+          mpq_class x,y,z;
+          assign_scalar(p.x(),x);
+          assign_scalar(p.y(),y);
+          assign_scalar(p.z(),z);
+          return CGAL::Point_3<type>(x,y,z);
+        }
+        static CGAL::Plane_3<type> to(const CGAL::Plane_3<Kernel> & P)
+        {
+          mpq_class a,b,c,d;
+          assign_scalar(P.a(),a);
+          assign_scalar(P.b(),b);
+          assign_scalar(P.c(),c);
+          assign_scalar(P.d(),d);
+          return CGAL::Plane_3<type>(a,b,c,d);
+        }
+        static CGAL::Point_3<Kernel> from(const CGAL::Point_3<type> & p)
+        {
+          typename Kernel::FT x,y,z;
+          assign_scalar(p.x(),x);
+          assign_scalar(p.y(),y);
+          assign_scalar(p.z(),z);
+          return CGAL::Point_3<Kernel>(x,y,z);
+        }
+      };
+#endif
+      // Convert an intersection object (see insert_into_cdt) to the kernel
+      // of the triangulations
+      template <typename Kernel>
+      IGL_INLINE CGAL::Object remesh_intersections_cdt_object(
+        const CGAL::Object & obj)
+      {
+        typedef RemeshIntersectionsCDTKernel<Kernel> CK;
+        typedef typename CK::type CDTKernel;
+        if(std::is_same<CDTKernel,Kernel>::value)
+        {
+          return obj;
+        }
+        if(const CGAL::Segment_3<Kernel> * seg =
+          CGAL::object_cast<CGAL::Segment_3<Kernel> >(&obj))
+        {
+          return CGAL::make_object(CGAL::Segment_3<CDTKernel>(
+            CK::to(seg->vertex(0)),CK::to(seg->vertex(1))));
+        }else if(const CGAL::Point_3<Kernel> * point =
+          CGAL::object_cast<CGAL::Point_3<Kernel> >(&obj))
+        {
+          return CGAL::make_object(CK::to(*point));
+        }else if(const CGAL::Triangle_3<Kernel> * tri =
+          CGAL::object_cast<CGAL::Triangle_3<Kernel> >(&obj))
+        {
+          return CGAL::make_object(CGAL::Triangle_3<CDTKernel>(
+            CK::to(tri->vertex(0)),
+            CK::to(tri->vertex(1)),
+            CK::to(tri->vertex(2))));
+        }else if(const std::vector<CGAL::Point_3<Kernel> > * poly =
+          CGAL::object_cast<std::vector<CGAL::Point_3<Kernel> > >(&obj))
+        {
+          std::vector<CGAL::Point_3<CDTKernel> > cpoly;
+          cpoly.reserve(poly->size());
+          for(const auto & p : *poly)
+          {
+            cpoly.push_back(CK::to(p));
+          }
+          return CGAL::make_object(cpoly);
+        }
+        throw std::runtime_error("Unknown intersection object!");
+      }
+    }
+  }
+}
+
 template <
   typename DerivedV,
   typename DerivedF,
@@ -69,21 +188,44 @@ IGL_INLINE void igl::copyleft::cgal::remesh_intersections(
   Eigen::PlainObjectBase<DerivedJ> & J,
   Eigen::PlainObjectBase<DerivedIM> & IM)
 {
+  RemeshIntersectionsTimings timings;
+  igl::copyleft::cgal::remesh_intersections(
+    V,F,T,offending,stitch_all,VV,FF,J,IM,timings);
+}
 
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename Kernel,
+  typename DerivedVV,
+  typename DerivedFF,
+  typename DerivedJ,
+  typename DerivedIM>
+IGL_INLINE void igl::copyleft::cgal::remesh_intersections(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F,
+  const std::vector<CGAL::Triangle_3<Kernel> > & T,
+  const std::map<
+    typename DerivedF::Index,
+    std::vector<
+      std::pair<typename DerivedF::Index, CGAL::Object> > > & offending,
+  bool stitch_all,
+  Eigen::PlainObjectBase<DerivedVV> & VV,
+  Eigen::PlainObjectBase<DerivedFF> & FF,
+  Eigen::PlainObjectBase<DerivedJ> & J,
+  Eigen::PlainObjectBase<DerivedIM> & IM,
+  RemeshIntersectionsTimings & timings)
+{
+    double t_start = igl::get_seconds();
+    const auto log_time = [&](const std::string& label, double & t) -> void {
+      const double t_now = igl::get_seconds();
+      t = t_now - t_start;
+      t_start = t_now;
 #ifdef REMESH_INTERSECTIONS_TIMING
-    const auto & tictoc = []() -> double
-    {
-      static double t_start = igl::get_seconds();
-      double diff = igl::get_seconds()-t_start;
-      t_start += diff;
-      return diff;
-    };
-    const auto log_time = [&](const std::string& label) -> void {
       std::cout << "remesh_intersections." << label << ": "
-          << tictoc() << std::endl;
-    };
-    tictoc();
+          << t << std::endl;
 #endif
+    };
 
     typedef CGAL::Point_3<Kernel>    Point_3;
     typedef CGAL::Segment_3<Kernel>  Segment_3; 
@@ -140,9 +282,7 @@ IGL_INLINE void igl::copyleft::cgal::remesh_intersections(
         }
       }
     }
-#ifdef REMESH_INTERSECTIONS_TIMING
-    log_time("overlap_analysis");
-#endif
+    log_time("overlap_analysis",timings.overlap_analysis);
 
     std::vector<std::vector<Index> > resolved_faces;
     std::vector<Index> source_faces;
@@ -151,44 +291,6 @@ IGL_INLINE void igl::copyleft::cgal::remesh_intersections(
     // face_vertices: Given a face Index, find vertices inside the face
     std::unordered_map<Index, std::vector<Index>> face_vertices;
 
-    // Run constraint Delaunay triangulation on the plane.
-    // 
-    // Inputs:
-    //   P  plane to triangulate upone
-    //   involved_faces  #F list of indices into triangle of involved faces
-    // Outputs:
-    //   vertices  #V list of vertex positions of output triangulation
-    //   faces   #F list of face indices into vertices of output triangulation
-    //
-    auto delaunay_triangulation = [&offending, &T](
-      const Plane_3& P,
-      const std::vector<Index>& involved_faces,
-      std::vector<Point_3>& vertices,
-      std::vector<std::vector<Index> >& faces) -> void 
-    {
-      std::vector<CGAL::Object> objects;
-
-      CDT_plus_2 cdt;
-      // insert each face into a common cdt
-      for (const auto& fid : involved_faces)
-      {
-        const auto itr = offending.find(fid);
-        const auto& triangle = T[fid];
-        objects.push_back(CGAL::make_object(triangle));
-        if (itr == offending.end())
-        {
-          continue;
-        }
-        for (const auto& index_obj : itr->second) 
-        {
-          //const auto& ofid = index_obj.first;
-          const auto& obj = index_obj.second;
-          objects.push_back(obj);
-        }
-      }
-      projected_cdt(objects,P,vertices,faces);
-    };
-
     // Given p on triangle indexed by ori_f, add point to list of vertices return index of p.
     //
     // Input:
@@ -377,43 +479,80 @@ IGL_INLINE void igl::copyleft::cgal::remesh_intersections(
       Plane_3 P = T[fid].supporting_plane();
       cdt_inputs.emplace_back(P, involved_faces);
     }
-#ifdef REMESH_INTERSECTIONS_TIMING
-    log_time("preprocess");
-#endif
+    log_time("preprocess",timings.preprocess);
 
+    typedef RemeshIntersectionsCDTKernel<Kernel> CK;
+    typedef typename CK::type CDTKernel;
     const size_t num_cdts = cdt_inputs.size();
-    std::vector<std::vector<Point_3> > cdt_vertices(num_cdts);
-    std::vector<std::vector<std::vector<Index> > > cdt_faces(num_cdts);
-
-    //// Not clear whether this is safe because of reference counting on Point_3
-    //// objects...
-    //// 
-    //// I tried it and got random segfaults (via MATLAB). Seems this is not
-    //// safe.
-    //igl::parallel_for(num_cdts,[&](int i)
+    // Gather the input of each constrained Delaunay triangulation: each
+    // involved face and all of its intersection objects, converted to the
+    // kernel of the triangulations
+    std::vector<std::vector<CGAL::Object> > cdt_objects(num_cdts);
+    std::vector<CGAL::Plane_3<CDTKernel> > cdt_planes;
+    cdt_planes.reserve(num_cdts);
     for (size_t i=0; i<num_cdts; i++) 
     {
-      auto& vertices = cdt_vertices[i];
-      auto& faces = cdt_faces[i];
-      const auto& P = cdt_inputs[i].first;
-      const auto& involved_faces = cdt_inputs[i].second;
-      delaunay_triangulation(P, involved_faces, vertices, faces);
+      cdt_planes.push_back(CK::to(cdt_inputs[i].first));
+      for (const auto& fid : cdt_inputs[i].second)
+      {
+        cdt_objects[i].push_back(
+          remesh_intersections_cdt_object<Kernel>(CGAL::make_object(T[fid])));
+        const auto itr = offending.find(fid);
+        if (itr == offending.end())
+        {
+          continue;
+        }
+        for (const auto& index_obj : itr->second) 
+        {
+          cdt_objects[i].push_back(
+            remesh_intersections_cdt_object<Kernel>(index_obj.second));
+        }
+      }
     }
-    //,1000);
-#ifdef REMESH_INTERSECTIONS_TIMING
-    log_time("cdt");
-#endif
+    std::vector<std::vector<CGAL::Point_3<CDTKernel> > > 
+      cdt_vertices(num_cdts);
+    std::vector<std::vector<std::vector<Index> > > cdt_faces(num_cdts);
+    // Each triangulation only touches its own input and output, so workers
+    // pull the next one (largest first) until none are left. The results
+    // are merged below in a fixed order, independent of the scheduling.
+    std::vector<size_t> order(num_cdts);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), 
+      [&cdt_objects](const size_t a, const size_t b)
+      { return cdt_objects[a].size() > cdt_objects[b].size(); });
+    std::atomic<size_t> next(0);
+    const auto triangulate = [&](const int)
+    {
+      while (true)
+      {
+        const size_t o = next++;
+        if (o >= num_cdts) break;
+        const size_t i = order[o];
+        projected_cdt(cdt_objects[i], cdt_planes[i], cdt_vertices[i], cdt_faces[i]);
+        // Free the input as soon as possible
+        std::vector<CGAL::Object>().swap(cdt_objects[i]);
+      }
+    };
+    const size_t sthc = std::thread::hardware_concurrency();
+    const size_t num_workers = 
+      CK::thread_safe ? std::min(num_cdts, sthc == 0 ? size_t(8) : sthc) : 1;
+    igl::parallel_for(num_workers, triangulate, 2);
+    log_time("cdt",timings.cdt);
 
+    std::vector<Point_3> vertices;
     for (size_t i=0; i<num_cdts; i++) 
     {
-      const auto& vertices = cdt_vertices[i];
+      vertices.clear();
+      vertices.reserve(cdt_vertices[i].size());
+      for (const auto& p : cdt_vertices[i])
+      {
+        vertices.push_back(CK::from(p));
+      }
       const auto& faces = cdt_faces[i];
       const auto& involved_faces = cdt_inputs[i].second;
       post_triangulation_process(vertices, faces, involved_faces);
     }
-#ifdef REMESH_INTERSECTIONS_TIMING
-    log_time("stitching");
-#endif
+    log_time("stitching",timings.stitching);
 
     // Output resolved mesh.
     const size_t num_out_vertices = new_vertices.size() + num_base_vertices;
@@ -475,9 +614,7 @@ IGL_INLINE void igl::copyleft::cgal::remesh_intersections(
       }
     }
 
-#ifdef REMESH_INTERSECTIONS_TIMING
-    log_time("store_results");
-#endif
+    log_time("store_results",timings.store_results);
 }
 
 #ifdef IGL_STATIC_LIBRARY
@@ -19,6 +19,21 @@ namespace igl
   {
     namespace cgal
     {
+      // Wall clock time (in seconds) spent in each stage of
+      // remesh_intersections
+      struct RemeshIntersectionsTimings
+      {
+        // clustering coplanar intersecting faces
+        double overlap_analysis = 0;
+        // gathering the input of each constrained Delaunay triangulation
+        double preprocess = 0;
+        // triangulating all intersected faces (in parallel)
+        double cdt = 0;
+        // merging the triangulations into one mesh
+        double stitching = 0;
+        // writing the output and finding duplicate vertices
+        double store_results = 0;
+      };
       // Remesh faces according to results of intersection detection and
       // construction (e.g. from `igl::copyleft::cgal::intersect_other` or
       // `igl::copyleft::cgal::SelfIntersectMesh`)
@@ -62,6 +77,32 @@ namespace igl
         Eigen::PlainObjectBase<DerivedFF> & FF,
         Eigen::PlainObjectBase<DerivedJ> & J,
         Eigen::PlainObjectBase<DerivedIM> & IM);
+      // Same as above but also reports the time spent in each stage
+      //
+      // Outputs:
+      //   timings  timings of each stage
+      template <
+        typename DerivedV,
+        typename DerivedF,
+        typename Kernel,
+        typename DerivedVV,
+        typename DerivedFF,
+        typename DerivedJ,
+        typename DerivedIM>
+      IGL_INLINE void remesh_intersections(
+        const Eigen::MatrixBase<DerivedV> & V,
+        const Eigen::MatrixBase<DerivedF> & F,
+        const std::vector<CGAL::Triangle_3<Kernel> > & T,
+        const std::map<
+          typename DerivedF::Index,
+            std::vector<
+            std::pair<typename DerivedF::Index, CGAL::Object> > > & offending,
+        bool stitch_all,
+        Eigen::PlainObjectBase<DerivedVV> & VV,
+        Eigen::PlainObjectBase<DerivedFF> & FF,
+        Eigen::PlainObjectBase<DerivedJ> & J,
+        Eigen::PlainObjectBase<DerivedIM> & IM,
+        RemeshIntersectionsTimings & timings);
       // Same as above except stitch_all is assumed "false"
       template <
         typename DerivedV,
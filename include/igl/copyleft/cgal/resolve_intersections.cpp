@@ -10,10 +10,18 @@
 #include "row_to_point.h"
 #include "../../unique.h"
 #include "../../list_to_matrix.h"
+#include "../../parallel_for.h"
+#include "../../segment_grid_cells.h"
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
 #include <CGAL/Segment_2.h>
 #include <CGAL/Point_2.h>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 template <
@@ -52,31 +60,141 @@ IGL_INLINE void igl::copyleft::cgal::resolve_intersections(
   }
 
   const int m = E.rows();
-  // resolve all intersections: silly O(n²) implementation
+  if(m == 0)
+  {
+    subdivide_segments(V,E,std::vector<std::vector<Point_2> >(),VI,EI,J,IM);
+    return;
+  }
+  // Floating point copy for the broad phase
+  Eigen::MatrixXd VD(VE.rows(),2);
+  for(int i = 0;i<VE.rows();i++)
+  {
+    VD(i,0) = CGAL::to_double(VE(i,0));
+    VD(i,1) = CGAL::to_double(VE(i,1));
+  }
+  // Uniform grid with cells about the size of an average segment
+  double h = 0;
+  for(int i = 0;i<m;i++)
+  {
+    h += (VD.row(E(i,0))-VD.row(E(i,1))).cwiseAbs().maxCoeff();
+  }
+  const Eigen::RowVector2d min_corner = VD.colwise().minCoeff();
+  const double extent = (VD.colwise().maxCoeff()-min_corner).maxCoeff();
+  h = std::max(h/m,extent/std::sqrt(double(m)));
+  if(!(h > 0))
+  {
+    h = 1;
+  }
+  // Touching segments must share a cell despite round off
+  const double margin = 
+    1e-10*(extent+min_corner.cwiseAbs().maxCoeff())+
+    std::numeric_limits<double>::min();
+  const auto & cells = [&](const int i, const std::function<void(int,int)> & f)
+  {
+    segment_grid_cells(
+      VD(E(i,0),0),VD(E(i,0),1),VD(E(i,1),0),VD(E(i,1),1),
+      min_corner(0),min_corner(1),h,margin,f);
+  };
+  // Only the floating point broad phase runs in parallel: exact numbers
+  // share reference counted construction histories that are not thread
+  // safe.
+  const size_t min_parallel = 1000;
+
+  // (cell, segment) entries, collected in per-thread buffers and sorted by
+  // cell
+  typedef std::pair<std::int64_t,int> Entry;
+  std::vector<Entry> entries;
+  {
+    std::vector<std::vector<Entry> > buffers;
+    igl::parallel_for(
+      m,
+      [&buffers](const size_t nt){ buffers.resize(nt); },
+      [&](const int i, const size_t t)
+      {
+        cells(i,[&](const int ci, const int cj)
+        {
+          buffers[t].emplace_back(segment_grid_cells_key(ci,cj),i);
+        });
+      },
+      [&buffers,&entries](const size_t t)
+      {
+        entries.insert(entries.end(),buffers[t].begin(),buffers[t].end());
+        std::vector<Entry>().swap(buffers[t]);
+      },
+      min_parallel);
+  }
+  std::sort(entries.begin(),entries.end());
+  // Range of entries of each cell
+  std::unordered_map<std::int64_t,std::pair<size_t,size_t> > cell_range;
+  cell_range.reserve(entries.size());
+  for(size_t e = 0;e<entries.size();)
+  {
+    size_t f = e;
+    while(f < entries.size() && entries[f].first == entries[e].first)
+    {
+      f++;
+    }
+    cell_range[entries[e].first] = std::make_pair(e,f);
+    e = f;
+  }
+
+  // Candidate pairs (i,j), i<j, of segments sharing a cell
+  std::vector<std::vector<int> > candidates(m);
+  igl::parallel_for(m,[&](const int i)
+  {
+    cells(i,[&](const int ci, const int cj)
+    {
+      const auto it = cell_range.find(segment_grid_cells_key(ci,cj));
+      if(it == cell_range.end())
+      {
+        return;
+      }
+      for(size_t e = it->second.first;e<it->second.second;e++)
+      {
+        if(entries[e].second > i)
+        {
+          candidates[i].push_back(entries[e].second);
+        }
+      }
+    });
+    std::sort(candidates[i].begin(),candidates[i].end());
+    candidates[i].erase(
+      std::unique(candidates[i].begin(),candidates[i].end()),
+      candidates[i].end());
+  },min_parallel);
+
+  // resolve intersections of candidate pairs: each pair is tested once and
+  // its intersection is added to both segments
+  std::vector<Segment_2> segments;
+  segments.reserve(m);
   std::vector<std::vector<Point_2> > steiner(m);
   for(int i = 0;i<m;i++)
   {
-    Segment_2 si(row_to_point<K>(VE,E(i,0)),row_to_point<K>(VE,E(i,1)));
-    steiner[i].push_back(si.vertex(0));
-    steiner[i].push_back(si.vertex(1));
-    for(int j = i+1;j<m;j++)
+    segments.emplace_back(row_to_point<K>(VE,E(i,0)),row_to_point<K>(VE,E(i,1)));
+    steiner[i].push_back(segments[i].vertex(0));
+    steiner[i].push_back(segments[i].vertex(1));
+  }
+  for(int i = 0;i<m;i++)
+  {
+    const Segment_2 & si = segments[i];
+    for(const int j : candidates[i])
     {
-      Segment_2 sj(row_to_point<K>(VE,E(j,0)),row_to_point<K>(VE,E(j,1)));
+      const Segment_2 & sj = segments[j];
       // do they intersect?
       if(CGAL::do_intersect(si,sj))
       {
         CGAL::Object result = CGAL::intersection(si,sj);
         if(const Point_2 * p = CGAL::object_cast<Point_2 >(&result))
         {
+          // add intersection point
           steiner[i].push_back(*p);
           steiner[j].push_back(*p);
-          // add intersection point
         }else if(const Segment_2 * s = CGAL::object_cast<Segment_2 >(&result))
         {
           // add both endpoints
           steiner[i].push_back(s->vertex(0));
-          steiner[j].push_back(s->vertex(0));
           steiner[i].push_back(s->vertex(1));
+          steiner[j].push_back(s->vertex(0));
           steiner[j].push_back(s->vertex(1));
         }else
         {
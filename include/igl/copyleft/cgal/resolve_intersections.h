@@ -17,6 +17,10 @@ namespace igl
     // RESOLVE_INTERSECTIONS Given a list of possible intersecting segments with
     // endpoints, split segments to overlap only at endpoints
     //
+    // Candidate pairs are segments sharing a cell of a uniform grid, found
+    // in parallel with floating point coordinates. Each pair is then
+    // intersected exactly once.
+    //
     // Inputs:
     //   V  #V by 2 list of vertex positions
     //   E  #E by 2 list of segment indices into V
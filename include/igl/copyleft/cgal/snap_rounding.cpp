@@ -9,12 +9,18 @@
 #include "resolve_intersections.h"
 #include "subdivide_segments.h"
 #include "../../remove_unreferenced.h"
-#include "../../unique.h"
+#include "../../parallel_for.h"
+#include "../../segment_grid_cells.h"
 #include <CGAL/Segment_2.h>
 #include <CGAL/Point_2.h>
 #include <CGAL/Vector_2.h>
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 template <
   typename DerivedV, 
@@ -98,51 +104,121 @@ IGL_INLINE void igl::copyleft::cgal::snap_rounding(
     search(-1);
     return i;
   };
-  vector<Point_2> hot;
-  for(int i = 0;i<VE.rows();i++)
+
+  // Pixel of each vertex and hot pixels (unique pixels of all vertices).
+  // Exact work runs serially: exact numbers share reference counted
+  // construction histories that are not thread safe. Only the floating
+  // point search for candidate hot pixels below runs in parallel.
+  const int nv = VE.rows();
+  MatrixXi RV(nv,2);
+  MatrixXd VD(nv,2);
+  vector<pair<int,int> > hot(nv);
+  for(int i = 0;i<nv;i++)
   {
-    hot.emplace_back(round(VE(i,0)),round(VE(i,1)));
+    RV(i,0) = round(VE(i,0));
+    RV(i,1) = round(VE(i,1));
+    VD(i,0) = CGAL::to_double(VE(i,0));
+    VD(i,1) = CGAL::to_double(VE(i,1));
+    hot[i] = make_pair(RV(i,0),RV(i,1));
   }
+  std::sort(hot.begin(),hot.end());
+  hot.erase(std::unique(hot.begin(),hot.end()),hot.end());
+
+  // Uniform grid of hot pixels with (integer) cells of about one hot pixel
+  // each
+  int cell_size = 1;
+  if(hot.size() > 0)
+  {
+    const RowVector2i min_corner = RV.colwise().minCoeff();
+    const RowVector2i max_corner = RV.colwise().maxCoeff();
+    const double extent = (max_corner-min_corner).maxCoeff()+1;
+    cell_size =
+      std::max(1,int(std::ceil(extent/std::sqrt(double(hot.size())))));
+  }
+  const auto & cell_of = [&cell_size](const int x)->int
+  {
+    return x >= 0 ? x/cell_size : -((-x+cell_size-1)/cell_size);
+  };
+  // hot sorted by cell
+  std::vector<std::pair<std::int64_t,int> > entries(hot.size());
+  for(int k = 0;k<(int)hot.size();k++)
   {
-    std::vector<size_t> _1,_2;
-    igl::unique(vector<Point_2>(hot),hot,_1,_2);
+    entries[k] = {
+      segment_grid_cells_key(cell_of(hot[k].first),cell_of(hot[k].second)),k};
   }
+  std::sort(entries.begin(),entries.end());
+  std::unordered_map<std::int64_t,std::pair<size_t,size_t> > cell_range;
+  cell_range.reserve(entries.size());
+  for(size_t e = 0;e<entries.size();)
+  {
+    size_t f = e;
+    while(f < entries.size() && entries[f].first == entries[e].first)
+    {
+      f++;
+    }
+    cell_range[entries[e].first] = std::make_pair(e,f);
+    e = f;
+  }
+
+  // Candidate hot pixels of each segment: those within reach of the
+  // segment (half a pixel plus round off) not containing an endpoint
+  vector<vector<int> > candidates(EI.rows());
+  igl::parallel_for(EI.rows(),[&](const int i)
+  {
+    const double sx = VD(EI(i,0),0), sy = VD(EI(i,0),1);
+    const double dx = VD(EI(i,1),0), dy = VD(EI(i,1),1);
+    const double margin = 
+      0.5+1e-8*(1.0+std::max(
+        std::max(std::abs(sx),std::abs(sy)),
+        std::max(std::abs(dx),std::abs(dy))));
+    // Cell c covers pixel centers c*cell_size ... (c+1)*cell_size-1
+    segment_grid_cells(sx,sy,dx,dy,-0.5,-0.5,cell_size,margin,
+      [&](const int ci, const int cj)
+    {
+      const auto it = cell_range.find(segment_grid_cells_key(ci,cj));
+      if(it == cell_range.end())
+      {
+        return;
+      }
+      for(size_t e = it->second.first;e<it->second.second;e++)
+      {
+        const pair<int,int> & hp = hot[entries[e].second];
+        // if either end-point is in h's pixel then ignore
+        if(
+          hp == pair<int,int>(RV(EI(i,0),0),RV(EI(i,0),1)) ||
+          hp == pair<int,int>(RV(EI(i,1),0),RV(EI(i,1),1)))
+        {
+          continue;
+        }
+        candidates[i].push_back(entries[e].second);
+      }
+    });
+  },1000);
 
   // find all segments intersecting hot pixels
   //   split edge at closest point to hot pixel center
   vector<vector<Point_2>>  steiner(EI.rows());
-  // initialize each segment with endpoints
   for(int i = 0;i<EI.rows();i++)
   {
-    steiner[i].emplace_back(VE(EI(i,0),0),VE(EI(i,0),1));
-    steiner[i].emplace_back(VE(EI(i,1),0),VE(EI(i,1),1));
-  }
-  // silly O(n²) implementation
-  for(const Point_2 & h : hot)
-  {
-    // North, East, South, West
-    Segment_2 wall[4] = 
-    {
-      {h+Vector_2(-0.5, 0.5),h+Vector_2( 0.5, 0.5)},
-      {h+Vector_2( 0.5, 0.5),h+Vector_2( 0.5,-0.5)},
-      {h+Vector_2( 0.5,-0.5),h+Vector_2(-0.5,-0.5)},
-      {h+Vector_2(-0.5,-0.5),h+Vector_2(-0.5, 0.5)}
-    };
-    // consider all segments
-    for(int i = 0;i<EI.rows();i++)
+    // endpoints
+    const Point_2 s(VE(EI(i,0),0),VE(EI(i,0),1));
+    const Point_2 d(VE(EI(i,1),0),VE(EI(i,1),1));
+    // initialize each segment with endpoints
+    steiner[i].push_back(s);
+    steiner[i].push_back(d);
+    const Segment_2 si(s,d);
+    for(const int k : candidates[i])
     {
-      // endpoints
-      const Point_2 s(VE(EI(i,0),0),VE(EI(i,0),1));
-      const Point_2 d(VE(EI(i,1),0),VE(EI(i,1),1));
-      // if either end-point is in h's pixel then ignore
-      const Point_2 rs(round(s.x()),round(s.y()));
-      const Point_2 rd(round(d.x()),round(d.y()));
-      if(h == rs || h == rd)
+      const Point_2 h(hot[k].first,hot[k].second);
+      // North, East, South, West
+      Segment_2 wall[4] = 
       {
-        continue;
-      }
+        {h+Vector_2(-0.5, 0.5),h+Vector_2( 0.5, 0.5)},
+        {h+Vector_2( 0.5, 0.5),h+Vector_2( 0.5,-0.5)},
+        {h+Vector_2( 0.5,-0.5),h+Vector_2(-0.5,-0.5)},
+        {h+Vector_2(-0.5,-0.5),h+Vector_2(-0.5, 0.5)}
+      };
       // otherwise check for intersections with walls consider all walls
-      const Segment_2 si(s,d);
       vector<Point_2> hits;
       for(int j = 0;j<4;j++)
       {
@@ -173,8 +249,8 @@ IGL_INLINE void igl::copyleft::cgal::snap_rounding(
       }
       cen = Vector_2(cen.x()/EScalar(hits.size()),cen.y()/EScalar(hits.size()));
       const Point_2 rcen(round(cen.x()),round(cen.y()));
-      // after all of that, don't add as a steiner unless it's going to round
-      // to h
+      // after all of that, don't add as a steiner unless it's going to
+      // round to h
       if(rcen == h)
       {
         steiner[i].emplace_back(cen.x(),cen.y());
@@ -20,6 +20,11 @@ namespace igl
       // SNAP_ROUNDING Snap a list of possible intersecting segments with
       // endpoints in any precision to _the_ integer grid.
       //
+      // Hot pixels are bucketed in a uniform grid, so each segment is only
+      // tested against the hot pixels along it. These candidates are found
+      // in parallel with floating point coordinates; the exact tests run
+      // serially.
+      //
       // Inputs:
       //   V  #V by 2 list of vertex positions
       //   E  #E by 2 list of segment indices into V
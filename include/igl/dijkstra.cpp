@@ -6,51 +6,251 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include <igl/dijkstra.h>
+#include "parallel_for.h"
+#include <limits>
+#include <utility>
 
-template <typename IndexType, typename DerivedD, typename DerivedP>
-IGL_INLINE int igl::dijkstra_compute_paths(const IndexType &source,
-                                           const std::set<IndexType> &targets,
-                                           const std::vector<std::vector<IndexType> >& VV,
-                                           Eigen::PlainObjectBase<DerivedD> &min_distance,
-                                           Eigen::PlainObjectBase<DerivedP> &previous)
+namespace igl
 {
-  int numV = VV.size();
-  min_distance.setConstant(numV, 1, std::numeric_limits<typename DerivedD::Scalar>::infinity());
-  min_distance[source] = 0;
-  previous.setConstant(numV, 1, -1);
-  std::set<std::pair<typename DerivedD::Scalar, IndexType> > vertex_queue;
-  vertex_queue.insert(std::make_pair(min_distance[source], source));
+  namespace dijkstra
+  {
+  // Binary min-heap of vertex indices keyed by (distance, index), which keeps
+  // track of the position of each vertex so that keys can be decreased in
+  // place. Ties are broken by index, matching the order of a std::set of
+  // (distance,index) pairs.
+  template <typename Scalar, typename IndexType>
+  class DijkstraHeap
+  {
+  public:
+    DijkstraHeap(const int n):pos(n,-1){}
+    bool empty() const { return heap.empty(); }
+    const std::pair<Scalar,IndexType> & top() const { return heap[0]; }
+    // Insert v with key d, or decrease the key of v to d
+    void push_or_decrease(const IndexType v, const Scalar d)
+    {
+      int i = pos[v];
+      if(i < 0)
+      {
+        i = heap.size();
+        heap.push_back(std::make_pair(d,v));
+      }else
+      {
+        heap[i].first = d;
+      }
+      sift_up(i);
+    }
+    void pop()
+    {
+      pos[heap[0].second] = -1;
+      heap[0] = heap.back();
+      heap.pop_back();
+      if(!heap.empty())
+      {
+        sift_down(0);
+      }
+    }
+    // Vertices currently in the heap (not yet settled)
+    const std::vector<std::pair<Scalar,IndexType> > & entries() const
+    {
+      return heap;
+    }
+  private:
+    void sift_up(int i)
+    {
+      const std::pair<Scalar,IndexType> e = heap[i];
+      while(i > 0)
+      {
+        const int p = (i-1)/2;
+        if(!(e < heap[p])) break;
+        heap[i] = heap[p];
+        pos[heap[i].second] = i;
+        i = p;
+      }
+      heap[i] = e;
+      pos[e.second] = i;
+    }
+    void sift_down(int i)
+    {
+      const int n = heap.size();
+      const std::pair<Scalar,IndexType> e = heap[i];
+      while(true)
+      {
+        int c = 2*i+1;
+        if(c >= n) break;
+        if(c+1 < n && heap[c+1] < heap[c]) c++;
+        if(!(heap[c] < e)) break;
+        heap[i] = heap[c];
+        pos[heap[i].second] = i;
+        i = c;
+      }
+      heap[i] = e;
+      pos[e.second] = i;
+    }
+    std::vector<std::pair<Scalar,IndexType> > heap;
+    std::vector<int> pos;
+  };
 
-  while (!vertex_queue.empty())
+  // Shared implementation of all versions of dijkstra_compute_paths.
+  //
+  // Inputs:
+  //   numV  number of vertices
+  //   neighbors  function handle so that neighbors(u,visit) calls
+  //     visit(v,w) for each edge from u to v of length w
+  //   first_only  whether to stop at the first target settled (and return
+  //     its index) rather than once all targets are settled (returning the
+  //     number of targets reached)
+  template <typename IndexType, typename NeighborFunc, typename DerivedD, typename DerivedP>
+  IGL_INLINE int dijkstra_compute_paths_helper(const IndexType &source,
+                                               const std::set<IndexType> &targets,
+                                               const int numV,
+                                               const NeighborFunc & neighbors,
+                                               const typename DerivedD::Scalar max_distance,
+                                               const bool first_only,
+                                               Eigen::PlainObjectBase<DerivedD> &min_distance,
+                                               Eigen::PlainObjectBase<DerivedP> &previous)
   {
-    typename DerivedD::Scalar dist = vertex_queue.begin()->first;
-    IndexType u = vertex_queue.begin()->second;
-    vertex_queue.erase(vertex_queue.begin());
+    typedef typename DerivedD::Scalar Scalar;
+    min_distance.setConstant(numV, 1, std::numeric_limits<Scalar>::infinity());
+    min_distance[source] = 0;
+    previous.setConstant(numV, 1, -1);
+    DijkstraHeap<Scalar,IndexType> vertex_queue(numV);
+    vertex_queue.push_or_decrease(source, 0);
+    int num_reached = 0;
+    while (!vertex_queue.empty())
+    {
+      const Scalar dist = vertex_queue.top().first;
+      const IndexType u = vertex_queue.top().second;
+      if (dist > max_distance)
+      {
+        break;
+      }
+      vertex_queue.pop();
 
-    if (targets.find(u)!= targets.end())
-      return u;
+      if (targets.find(u) != targets.end())
+      {
+        if (first_only)
+          return u;
+        if (++num_reached == (int)targets.size())
+          return num_reached;
+      }
 
-    // Visit each edge exiting u
-    const std::vector<int> &neighbors = VV[u];
-    for (std::vector<int>::const_iterator neighbor_iter = neighbors.begin();
-         neighbor_iter != neighbors.end();
-         neighbor_iter++)
+      // Visit each edge exiting u
+      neighbors(u, [&](const IndexType v, const Scalar w)
+      {
+        const Scalar distance_through_u = dist + w;
+        if (distance_through_u < min_distance[v])
+        {
+          min_distance[v] = distance_through_u;
+          previous[v] = u;
+          vertex_queue.push_or_decrease(v, distance_through_u);
+        }
+      });
+    }
+    // Vertices left in the queue lie beyond the search radius
+    for (const auto & e : vertex_queue.entries())
     {
-      IndexType v = *neighbor_iter;
-      typename DerivedD::Scalar distance_through_u = dist + 1.;
-      if (distance_through_u < min_distance[v]) {
-        vertex_queue.erase(std::make_pair(min_distance[v], v));
-
-        min_distance[v] = distance_through_u;
-        previous[v] = u;
-        vertex_queue.insert(std::make_pair(min_distance[v], v));
+      min_distance[e.second] = std::numeric_limits<Scalar>::infinity();
+      previous[e.second] = -1;
+    }
+    return first_only ? -1 : num_reached;
+  }
 
+  // Neighbors and edge lengths from an adjacency list and a weight function
+  template <typename IndexType, typename WeightFunc>
+  struct DijkstraAdjacencyList
+  {
+    const std::vector<std::vector<IndexType> > & VV;
+    const WeightFunc & weight;
+    template <typename VisitFunc>
+    void operator()(const IndexType u, const VisitFunc & visit) const
+    {
+      for (const IndexType v : VV[u])
+      {
+        visit(v, weight(u,v));
       }
+    }
+  };
 
+  // Neighbors and edge lengths from a sparse matrix
+  template <typename IndexType, typename Scalar>
+  struct DijkstraSparseMatrix
+  {
+    const Eigen::SparseMatrix<Scalar> & A;
+    template <typename VisitFunc>
+    void operator()(const IndexType u, const VisitFunc & visit) const
+    {
+      for (typename Eigen::SparseMatrix<Scalar>::InnerIterator it(A,u); it; ++it)
+      {
+        visit(IndexType(it.row()), it.value());
+      }
     }
+  };
   }
-  //we should never get here
-  return -1;
+}
+
+template <typename IndexType, typename DerivedD, typename DerivedP>
+IGL_INLINE int igl::dijkstra_compute_paths(const IndexType &source,
+                                           const std::set<IndexType> &targets,
+                                           const std::vector<std::vector<IndexType> >& VV,
+                                           Eigen::PlainObjectBase<DerivedD> &min_distance,
+                                           Eigen::PlainObjectBase<DerivedP> &previous)
+{
+  typedef typename DerivedD::Scalar Scalar;
+  const auto & unit = [](const IndexType, const IndexType)->Scalar{ return 1.; };
+  const dijkstra::DijkstraAdjacencyList<IndexType,decltype(unit)> neighbors{VV,unit};
+  return dijkstra::dijkstra_compute_paths_helper(
+    source, targets, VV.size(), neighbors,
+    std::numeric_limits<Scalar>::infinity(), true, min_distance, previous);
+}
+
+template <typename IndexType, typename WeightFunc, typename DerivedD, typename DerivedP>
+IGL_INLINE int igl::dijkstra_compute_paths(const IndexType &source,
+                                           const std::set<IndexType> &targets,
+                                           const std::vector<std::vector<IndexType> >& VV,
+                                           const WeightFunc & weight,
+                                           const typename DerivedD::Scalar max_distance,
+                                           Eigen::PlainObjectBase<DerivedD> &min_distance,
+                                           Eigen::PlainObjectBase<DerivedP> &previous)
+{
+  const dijkstra::DijkstraAdjacencyList<IndexType,WeightFunc> neighbors{VV,weight};
+  return dijkstra::dijkstra_compute_paths_helper(
+    source, targets, VV.size(), neighbors, max_distance, false,
+    min_distance, previous);
+}
+
+template <typename IndexType, typename Scalar, typename DerivedD, typename DerivedP>
+IGL_INLINE int igl::dijkstra_compute_paths(const IndexType &source,
+                                           const std::set<IndexType> &targets,
+                                           const Eigen::SparseMatrix<Scalar> & A,
+                                           const typename DerivedD::Scalar max_distance,
+                                           Eigen::PlainObjectBase<DerivedD> &min_distance,
+                                           Eigen::PlainObjectBase<DerivedP> &previous)
+{
+  assert(A.rows() == A.cols() && "A should be square");
+  const dijkstra::DijkstraSparseMatrix<IndexType,Scalar> neighbors{A};
+  return dijkstra::dijkstra_compute_paths_helper(
+    source, targets, A.cols(), neighbors, max_distance, false,
+    min_distance, previous);
+}
+
+template <typename DerivedS, typename IndexType, typename Scalar, typename DerivedD>
+IGL_INLINE void igl::dijkstra_compute_paths_batch(const Eigen::MatrixBase<DerivedS> &S,
+                                                  const std::set<IndexType> &targets,
+                                                  const Eigen::SparseMatrix<Scalar> & A,
+                                                  const typename DerivedD::Scalar max_distance,
+                                                  Eigen::PlainObjectBase<DerivedD> &D)
+{
+  typedef typename DerivedD::Scalar DScalar;
+  D.resize(A.cols(), S.size());
+  parallel_for(S.size(), [&](const int s)
+  {
+    Eigen::Matrix<DScalar,Eigen::Dynamic,1> min_distance;
+    Eigen::Matrix<IndexType,Eigen::Dynamic,1> previous;
+    const IndexType source = S(s);
+    dijkstra_compute_paths(
+      source, targets, A, max_distance, min_distance, previous);
+    D.col(s) = min_distance;
+  },2);
 }
 
 template <typename IndexType, typename DerivedP>
@@ -67,5 +267,8 @@ IGL_INLINE void igl::dijkstra_get_shortest_path_to(const IndexType &vertex,
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template instantiation
 template int igl::dijkstra_compute_paths<int, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(int const&, std::set<int, std::less<int>, std::allocator<int> > const&, std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template int igl::dijkstra_compute_paths<int, std::function<double (int, int)>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(int const&, std::set<int, std::less<int>, std::allocator<int> > const&, std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > > const&, std::function<double (int, int)> const&, double, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template int igl::dijkstra_compute_paths<int, double, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(int const&, std::set<int, std::less<int>, std::allocator<int> > const&, Eigen::SparseMatrix<double, 0, int> const&, double, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::dijkstra_compute_paths_batch<Eigen::Matrix<int, -1, 1, 0, -1, 1>, int, double, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, std::set<int, std::less<int>, std::allocator<int> > const&, Eigen::SparseMatrix<double, 0, int> const&, double, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
 template void igl::dijkstra_get_shortest_path_to<int, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(int const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, std::vector<int, std::allocator<int> >&);
 #endif
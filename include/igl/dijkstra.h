@@ -11,6 +11,8 @@
 #include "igl_inline.h"
 
 #include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <functional>
 #include <vector>
 #include <set>
 
@@ -36,6 +38,71 @@ namespace igl {
                                         Eigen::PlainObjectBase<DerivedD> &min_distance,
                                         Eigen::PlainObjectBase<DerivedP> &previous);
 
+  // Dijkstra's algorithm for weighted shortest paths, stopping once all
+  // targets are settled or once the search radius is exceeded.
+  //
+  // Inputs:
+  //   source           index of source vertex
+  //   targets          target vector set (empty means settle all vertices)
+  //   VV               #V list of lists of incident vertices (adjacency list), e.g.
+  //                    as returned by igl::adjacency_list
+  //   weight           function handle (e.g., a lambda) so that weight(u,v)
+  //                    is the (non-negative) length of the edge from u to v
+  //   max_distance     search radius: vertices farther than this are not
+  //                    settled
+  //
+  // Output:
+  //   min_distance     #V by 1 list of the minimum distances from source to all
+  //                    vertices. Vertices beyond max_distance are set to
+  //                    infinity. If the search stopped early because all
+  //                    targets were settled, entries of unsettled vertices
+  //                    are upper bounds.
+  //   previous         #V by 1 list of the previous visited vertices (for each vertex) - used for backtracking
+  // Returns number of targets reached
+  //
+  template <typename IndexType, typename WeightFunc, typename DerivedD, typename DerivedP>
+  IGL_INLINE int dijkstra_compute_paths(const IndexType &source,
+                                        const std::set<IndexType> &targets,
+                                        const std::vector<std::vector<IndexType> >& VV,
+                                        const WeightFunc & weight,
+                                        const typename DerivedD::Scalar max_distance,
+                                        Eigen::PlainObjectBase<DerivedD> &min_distance,
+                                        Eigen::PlainObjectBase<DerivedP> &previous);
+  // Same as above but with the weighted graph given as a sparse matrix.
+  //
+  // Inputs:
+  //   A                #V by #V sparse matrix so that A(v,u) is the
+  //                    (non-negative) length of the edge from u to v, e.g.,
+  //                    adjacency_matrix with entries replaced by edge lengths
+  template <typename IndexType, typename Scalar, typename DerivedD, typename DerivedP>
+  IGL_INLINE int dijkstra_compute_paths(const IndexType &source,
+                                        const std::set<IndexType> &targets,
+                                        const Eigen::SparseMatrix<Scalar> & A,
+                                        const typename DerivedD::Scalar max_distance,
+                                        Eigen::PlainObjectBase<DerivedD> &min_distance,
+                                        Eigen::PlainObjectBase<DerivedP> &previous);
+  // Run Dijkstra's algorithm from many sources independently and in
+  // parallel.
+  //
+  // Inputs:
+  //   S                #S list of source vertex indices
+  //   targets          target vector set shared by all sources (empty means
+  //                    settle all vertices)
+  //   A                #V by #V sparse matrix of edge lengths (see above)
+  //   max_distance     search radius
+  // Outputs:
+  //   D                #V by #S list of minimum distances, so that D(:,s)
+  //                    are the distances from S(s) (see min_distance above).
+  //                    If targets is not empty, the search from S(s) stops
+  //                    once all targets are settled, and D(v,s) is only an
+  //                    upper bound for vertices v not settled by then.
+  template <typename DerivedS, typename IndexType, typename Scalar, typename DerivedD>
+  IGL_INLINE void dijkstra_compute_paths_batch(const Eigen::MatrixBase<DerivedS> &S,
+                                               const std::set<IndexType> &targets,
+                                               const Eigen::SparseMatrix<Scalar> & A,
+                                               const typename DerivedD::Scalar max_distance,
+                                               Eigen::PlainObjectBase<DerivedD> &D);
+
   // Backtracking after Dijstra's algorithm, to find shortest path.
   //
   // Inputs:
@@ -13,6 +13,7 @@
 // Compiled into a single file by Zhongshi Jiang
 
 #include <igl/PI.h>
+#include <igl/parallel_for.h>
 #include <algorithm>
 #include <cassert>
 #include <cmath>
@@ -157,10 +158,11 @@ public:
 
 	~MemoryAllocator(){};
 
-	void clear()
-	{
-		reset(m_block_size, 
-			  m_max_number_of_blocks);
+	void clear()		//recycles all blocks allocated so far, so that repeated
+	{					//propagations do not reallocate their storage
+		m_current_block = 0;
+		m_current_position = 0;
+		m_deleted.clear();
 	}
 
 	void reset(unsigned block_size, 
@@ -172,6 +174,7 @@ public:
 		assert(m_block_size > 0);
 		assert(m_max_number_of_blocks > 0);
 
+		m_current_block = 0;
 		m_current_position = 0;
 
 		m_storage.reserve(max_number_of_blocks);
@@ -189,11 +192,15 @@ public:
 		{
 			if(m_current_position + 1 >= m_block_size)
 			{
-				m_storage.push_back( std::vector<T>() );
-				m_storage.back().resize(m_block_size);
+				++m_current_block;
+				if(m_current_block == m_storage.size())
+				{
+					m_storage.push_back( std::vector<T>() );
+					m_storage.back().resize(m_block_size);
+				}
 				m_current_position = 0;
 			}
-			result = & m_storage.back()[m_current_position];
+			result = & m_storage[m_current_block][m_current_position];
 			++m_current_position;
 		}
 		else
@@ -217,6 +224,7 @@ private:
 	std::vector<std::vector<T> > m_storage;
 	unsigned m_block_size;				//size of a single block
 	unsigned m_max_number_of_blocks;		//maximum allowed number of blocks
+	unsigned m_current_block;			//block currently being filled
 	unsigned m_current_position;			//first unused element inside the current block
 
 	std::vector<pointer> m_deleted;			//pointers to deleted elemets
@@ -3197,7 +3205,7 @@ IGL_INLINE void igl::exact_geodesic(
   }
   for (int i = 0; i < FS.rows(); i++)
   {
-    source[i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FS(i)]));
+    source[VS.rows() + i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FS(i)]));
   }
 
   for (int i = 0; i < VT.rows(); i++)
@@ -3206,7 +3214,7 @@ IGL_INLINE void igl::exact_geodesic(
   }
   for (int i = 0; i < FT.rows(); i++)
   {
-    target[i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FT(i)]));
+    target[VT.rows() + i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FT(i)]));
   }
 
   exact_algorithm.propagate(source);
@@ -3219,6 +3227,90 @@ IGL_INLINE void igl::exact_geodesic(
   }
 }
 
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedVS,
+  typename DerivedFS,
+  typename DerivedVT,
+  typename DerivedFT,
+  typename DerivedD>
+IGL_INLINE void igl::exact_geodesic_matrix(
+  const Eigen::MatrixBase<DerivedV> &V,
+  const Eigen::MatrixBase<DerivedF> &F,
+  const Eigen::MatrixBase<DerivedVS> &VS,
+  const Eigen::MatrixBase<DerivedFS> &FS,
+  const Eigen::MatrixBase<DerivedVT> &VT,
+  const Eigen::MatrixBase<DerivedFT> &FT,
+  Eigen::PlainObjectBase<DerivedD> &D)
+{
+  assert(V.cols() == 3 && F.cols() == 3 && "Only support 3D triangle mesh");
+  assert(VS.cols() ==1 && FS.cols() == 1 && VT.cols() == 1 && FT.cols() ==1 && "Only support one dimensional inputs");
+  std::vector<typename DerivedV::Scalar> points(V.rows() * V.cols());
+  std::vector<typename DerivedF::Scalar> faces(F.rows() * F.cols());
+  for (int i = 0; i < points.size(); i++)
+  {
+    points[i] = V(i / 3, i % 3);
+  }
+  for (int i = 0; i < faces.size(); i++)
+  {
+    faces[i] = F(i / 3, i % 3);
+  }
+
+  // Connectivity is only read during propagation so it can be shared
+  igl::geodesic::Mesh mesh;
+  mesh.initialize_mesh_data(points, faces);
+
+  std::vector<igl::geodesic::SurfacePoint> source(VS.rows() + FS.rows());
+  std::vector<igl::geodesic::SurfacePoint> target(VT.rows() + FT.rows());
+  for (int i = 0; i < VS.rows(); i++)
+  {
+    source[i] = (igl::geodesic::SurfacePoint(&mesh.vertices()[VS(i)]));
+  }
+  for (int i = 0; i < FS.rows(); i++)
+  {
+    source[VS.rows() + i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FS(i)]));
+  }
+  for (int i = 0; i < VT.rows(); i++)
+  {
+    target[i] = (igl::geodesic::SurfacePoint(&mesh.vertices()[VT(i)]));
+  }
+  for (int i = 0; i < FT.rows(); i++)
+  {
+    target[VT.rows() + i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FT(i)]));
+  }
+
+  D.resize(source.size(), target.size());
+  // One propagation workspace per thread, created on first use
+  std::vector<std::unique_ptr<igl::geodesic::GeodesicAlgorithmExact> >
+    algorithms;
+  const auto & prep = [&algorithms](const size_t nthreads)
+  {
+    algorithms.resize(nthreads);
+  };
+  const auto & inner = [&](const int s, const size_t t)
+  {
+    if(!algorithms[t])
+    {
+      algorithms[t].reset(new igl::geodesic::GeodesicAlgorithmExact(&mesh));
+    }
+    igl::geodesic::GeodesicAlgorithmExact & exact_algorithm = *algorithms[t];
+    std::vector<igl::geodesic::SurfacePoint> single_source(1, source[s]);
+    std::vector<igl::geodesic::SurfacePoint> stop_points(target);
+    exact_algorithm.propagate(
+      single_source, igl::geodesic::GEODESIC_INF, &stop_points);
+    for (int j = 0; j < stop_points.size(); j++)
+    {
+      double distance;
+      exact_algorithm.best_source(stop_points[j], distance);
+      D(s, j) = distance;
+    }
+  };
+  const auto & no_op = [](const size_t /*t*/){};
+  igl::parallel_for(source.size(), prep, inner, no_op, 2);
+}
+
 #ifdef IGL_STATIC_LIBRARY
 template void igl::exact_geodesic<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>>(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1>> &);
+template void igl::exact_geodesic_matrix<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>>(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1>> &);
 #endif
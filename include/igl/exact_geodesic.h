@@ -46,6 +46,39 @@ namespace igl
       const Eigen::MatrixBase<DerivedVT> &VT,
       const Eigen::MatrixBase<DerivedFT> &FT,
       Eigen::PlainObjectBase<DerivedD> &D);
+  // Exact geodesic distances from each of many sources to a common set of
+  // targets (e.g., all-pairs or landmark distance matrices). The mesh
+  // connectivity is built once and shared by all sources. Sources are
+  // distributed across threads and each thread reuses a single propagation
+  // workspace (edge interval lists and interval memory pool) for all of its
+  // sources. Propagation from each source stops once all targets are covered.
+  //
+  // Inputs:
+  //   V  #V by 3 list of 3D vertex positions
+  //   F  #F by 3 list of mesh faces
+  //   VS #VS by 1 vector specifying indices of source vertices
+  //   FS #FS by 1 vector specifying indices of source faces
+  //   VT #VT by 1 vector specifying indices of target vertices
+  //   FT #FT by 1 vector specifying indices of target faces
+  // Output:
+  //   D  #VS+#FS by #VT+#FT matrix of geodesic distances, so that D(i,j) is
+  //     the distance from the ith source to the jth target
+    template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedVS,
+    typename DerivedFS,
+    typename DerivedVT,
+    typename DerivedFT,
+    typename DerivedD>
+    IGL_INLINE void exact_geodesic_matrix(
+      const Eigen::MatrixBase<DerivedV> &V,
+      const Eigen::MatrixBase<DerivedF> &F,
+      const Eigen::MatrixBase<DerivedVS> &VS,
+      const Eigen::MatrixBase<DerivedFS> &FS,
+      const Eigen::MatrixBase<DerivedVT> &VT,
+      const Eigen::MatrixBase<DerivedFT> &FT,
+      Eigen::PlainObjectBase<DerivedD> &D);
 }
 
 #ifndef IGL_STATIC_LIBRARY
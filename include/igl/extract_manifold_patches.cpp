@@ -6,10 +6,10 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "extract_manifold_patches.h"
+#include "parallel_for.h"
 #include "unique_edge_map.h"
+#include "UnionFind.h"
 #include <cassert>
-#include <limits>
-#include <queue>
 
 template<
   typename DerivedF,
@@ -45,33 +45,17 @@ IGL_INLINE size_t igl::extract_manifold_patches(
         }
     };
 
-    typedef typename DerivedP::Scalar Scalar;
-    const Scalar INVALID = std::numeric_limits<Scalar>::max();
-    P.resize(num_faces,1);
-    P.setConstant(INVALID);
-    size_t num_patches = 0;
-    for (size_t i=0; i<num_faces; i++) {
-        if (P(i,0) != INVALID) continue;
-
-        std::queue<size_t> Q;
-        Q.push(i);
-        P(i,0) = num_patches;
-        while (!Q.empty()) {
-            const size_t fid = Q.front();
-            Q.pop();
-            for (size_t j=0; j<3; j++) {
-                if (is_manifold_edge(fid, j)) {
-                    const size_t adj_fid = get_adj_face_index(fid, j);
-                    if (P(adj_fid,0) == INVALID) {
-                        Q.push(adj_fid);
-                        P(adj_fid,0) = num_patches;
-                    }
-                }
+    UnionFind uf(num_faces);
+    parallel_for(num_faces, [&](const size_t fid) {
+        for (size_t j=0; j<3; j++) {
+            if (is_manifold_edge(fid, j)) {
+                uf.unite(fid, get_adj_face_index(fid, j));
             }
         }
-        num_patches++;
-    }
-    assert((P.array() != INVALID).all());
+    }, 1000);
+    Eigen::VectorXi counts;
+    uf.labels(P, counts);
+    const size_t num_patches = counts.size();
 
     return num_patches;
 }
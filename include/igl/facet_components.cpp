@@ -7,8 +7,9 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "facet_components.h"
 #include <igl/triangle_triangle_adjacency.h>
+#include <igl/parallel_for.h>
+#include <igl/UnionFind.h>
 #include <vector>
-#include <queue>
 template <typename DerivedF, typename DerivedC>
 IGL_INLINE void igl::facet_components(
   const Eigen::PlainObjectBase<DerivedF> & F,
@@ -32,56 +33,21 @@ IGL_INLINE void igl::facet_components(
   Eigen::PlainObjectBase<DerivedC> & C,
   Eigen::PlainObjectBase<Derivedcounts> & counts)
 {
-  using namespace std;
-  typedef TTIndex Index;
-  const Index m = TT.size();
-  C.resize(m,1);
-  vector<bool> seen(m,false);
-  Index id = 0;
-  vector<Index> vcounts;
-  for(Index g = 0;g<m;g++)
+  const int m = TT.size();
+  UnionFind uf(m);
+  parallel_for(m,[&TT,&uf](const int f)
   {
-    if(seen[g])
-    {
-      continue;
-    }
-    vcounts.push_back(0);
-    queue<Index> Q;
-    Q.push(g);
-    while(!Q.empty())
+    // Face f's neighbor lists opposite opposite each corner
+    for(const auto & c : TT[f])
     {
-      const Index f = Q.front();
-      Q.pop();
-      if(seen[f])
+      // Each neighbor
+      for(const auto & n : c)
       {
-        continue;
-      }
-      seen[f] = true;
-      vcounts[id]++;
-      C(f,0) = id;
-      // Face f's neighbor lists opposite opposite each corner
-      for(const auto & c : TT[f])
-      {
-        // Each neighbor
-        for(const auto & n : c)
-        {
-          if(!seen[n])
-          {
-            Q.push(n);
-          }
-        }
+        uf.unite(f,n);
       }
     }
-    id++;
-  }
-  assert((size_t) id == vcounts.size());
-  const size_t ncc = vcounts.size();
-  assert((size_t)C.maxCoeff()+1 == ncc);
-  counts.resize(ncc,1);
-  for(size_t i = 0;i<ncc;i++)
-  {
-    counts(i) = vcounts[i];
-  }
+  },1000);
+  uf.labels(C,counts);
 }
 
 #ifdef IGL_STATIC_LIBRARY
@@ -96,19 +96,17 @@ IGL_INLINE bool igl::harmonic(
   typedef DerivedL Scalar;
   min_quad_with_fixed_data<Scalar> data;
   min_quad_with_fixed_precompute(Q,b,Eigen::SparseMatrix<Scalar>(),true,data);
-  W.resize(n,bc.cols());
   typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+  typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixXS;
   const VectorXS B = VectorXS::Zero(n,1);
-  for(int w = 0;w<bc.cols();w++)
+  // Solve for all columns at once
+  const MatrixXS bcS = bc.template cast<Scalar>();
+  MatrixXS WS;
+  if(!min_quad_with_fixed_solve(data,B,bcS,VectorXS(),WS))
   {
-    const VectorXS bcw = bc.col(w);
-    VectorXS Ww;
-    if(!min_quad_with_fixed_solve(data,B,bcw,VectorXS(),Ww))
-    {
-      return false;
-    }
-    W.col(w) = Ww;
+    return false;
   }
+  W = WS.template cast<typename DerivedW::Scalar>();
   return true;
 }
 
@@ -7,6 +7,13 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "hausdorff.h"
 #include "point_mesh_squared_distance.h"
+#include "AABB.h"
+#include "parallel_for.h"
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
 
 template <
   typename DerivedVA, 
@@ -36,6 +43,248 @@ IGL_INLINE void igl::hausdorff(
   d = sqrt(std::max(dba,dab));
 }
 
+namespace igl
+{
+  // Bounds on the Hausdorff distance between a triangle and a point-set
+  // given the distances of the triangle's corners to the point-set.
+  //
+  // Inputs:
+  //   V   3 by 3 list of corner positions
+  //   d   3-long list of distances from each corner to B
+  // Outputs:
+  //   l  lower bound on Hausdorff distance 
+  //   u  upper bound on Hausdorff distance
+  template <typename DerivedV, typename Derivedd, typename Scalar>
+  IGL_INLINE void hausdorff_triangle_bounds(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<Derivedd>& d,
+    Scalar & l,
+    Scalar & u)
+  {
+    // e  3-long vector of opposite edge lengths
+    Eigen::Matrix<typename DerivedV::Scalar,1,3> e;
+    // Maximum edge length
+    Scalar e_max = 0;
+    for(int i=0;i<3;i++)
+    {
+      e(i) = (V.row((i+1)%3)-V.row((i+2)%3)).norm();
+      e_max = std::max(e_max,e(i));
+    }
+    // Semiperimeter
+    const Scalar s = (e(0)+e(1)+e(2))*0.5;
+    // Area
+    const Scalar A = sqrt(s*(s-e(0))*(s-e(1))*(s-e(2)));
+    // Circumradius
+    const Scalar R = e(0)*e(1)*e(2)/(4.*A);
+    // inradius
+    const Scalar r = A/s;
+    l = 0;
+    Scalar u1 = std::numeric_limits<Scalar>::infinity();
+    Scalar u2 = 0;
+    for(int i=0;i<3;i++)
+    {
+      // Lower bound is simply the max over vertex distances
+      l = std::max(Scalar(d(i)),l);
+      // u1 is the minimum of corner distances + maximum adjacent edge 
+      u1 = std::min(u1,Scalar(d(i) + std::max(e((i+1)%3),e((i+2)%3))));
+      // u2 first takes the maximum over corner distances
+      u2 = std::max(u2,Scalar(d(i)));
+    }
+    // u2 is the distance from the circumcenter/midpoint of obtuse edge plus
+    // the largest corner distance 
+    u2 += (s-r>2.*R ? R : 0.5*e_max);
+    u = std::min(u1,u2);
+  }
+
+  // Raise an atomic value to at least x
+  inline void hausdorff_atomic_max(std::atomic<double> & a, const double x)
+  {
+    double prev = a.load();
+    while(prev < x && !a.compare_exchange_weak(prev,x))
+    {
+    }
+  }
+
+  // Bounds (l,u) on the one-sided Hausdorff distance max_{a∈A} d(a,B), with
+  // u-l ≤ max_error unless some triangle reached max_depth subdivisions
+  IGL_INLINE void hausdorff_one_sided(
+    const Eigen::MatrixXd & VA,
+    const Eigen::MatrixXi & FA,
+    const Eigen::MatrixXd & VB,
+    const Eigen::MatrixXi & FB,
+    const double max_error,
+    const int max_depth,
+    double & l,
+    double & u)
+  {
+    typedef Eigen::RowVector3d RowVector3d;
+    if(FA.rows() == 0)
+    {
+      l = u = 0;
+      return;
+    }
+    if(FB.rows() == 0)
+    {
+      l = u = std::numeric_limits<double>::infinity();
+      return;
+    }
+    AABB<Eigen::MatrixXd,3> treeB;
+    treeB.init(VB,FB);
+    // Distance from p to B, known to be at most hint
+    const auto & dist_to_B = [&](const RowVector3d & p, const double hint)
+    {
+      int i;
+      RowVector3d c;
+      const double up_sqr_d = hint < std::numeric_limits<double>::infinity() ?
+        hint*hint*(1.+1e-10)+std::numeric_limits<double>::min() : hint;
+      return std::sqrt(treeB.squared_distance(VB,FB,p,up_sqr_d,i,c));
+    };
+    // Distances of the corners of A
+    std::vector<char> referenced(VA.rows(),0);
+    for(int f = 0;f<FA.size();f++)
+    {
+      referenced[FA(f)] = 1;
+    }
+    Eigen::VectorXd dA = Eigen::VectorXd::Zero(VA.rows());
+    parallel_for(VA.rows(),[&](const int v)
+    {
+      if(referenced[v])
+      {
+        dA(v) = dist_to_B(VA.row(v),std::numeric_limits<double>::infinity());
+      }
+    },1000);
+    // Lower bound (attained) and upper bound of everything pruned so far
+    std::atomic<double> L(dA.maxCoeff());
+    std::atomic<double> U(L.load());
+
+    // Adaptively subdivide a triangle until its bounds are tight enough
+    const std::function<void(
+      const Eigen::Matrix3d &,const RowVector3d &,const int)> refine = 
+      [&](const Eigen::Matrix3d & T, const RowVector3d & d, const int depth)
+    {
+      double lT,uT;
+      hausdorff_triangle_bounds(T,d,lT,uT);
+      hausdorff_atomic_max(L,lT);
+      if(uT <= L.load()+max_error || depth == max_depth)
+      {
+        hausdorff_atomic_max(U,uT);
+        return;
+      }
+      // Split into 4 at edge midpoints (M.row(i) is opposite corner i)
+      Eigen::Matrix3d M;
+      RowVector3d dM;
+      for(int i = 0;i<3;i++)
+      {
+        const int j = (i+1)%3;
+        const int k = (i+2)%3;
+        M.row(i) = 0.5*(T.row(j)+T.row(k));
+        dM(i) = dist_to_B(
+          M.row(i),std::min(d(j),d(k))+0.5*(T.row(j)-T.row(k)).norm());
+      }
+      for(int i = 0;i<3;i++)
+      {
+        const int j = (i+1)%3;
+        const int k = (i+2)%3;
+        Eigen::Matrix3d C;
+        C<<T.row(i),M.row(k),M.row(j);
+        refine(C,RowVector3d(d(i),dM(k),dM(j)),depth+1);
+      }
+      refine(M,dM,depth+1);
+    };
+    // Traverse the hierarchy of A, pruning boxes too close to B
+    AABB<Eigen::MatrixXd,3> treeA;
+    treeA.init(VA,FA);
+    const std::function<void(const AABB<Eigen::MatrixXd,3> &)> traverse =
+      [&](const AABB<Eigen::MatrixXd,3> & node)
+    {
+      if(node.is_leaf())
+      {
+        const int f = node.m_primitive;
+        Eigen::Matrix3d T;
+        T<<VA.row(FA(f,0)),VA.row(FA(f,1)),VA.row(FA(f,2));
+        refine(T,RowVector3d(dA(FA(f,0)),dA(FA(f,1)),dA(FA(f,2))),0);
+        return;
+      }
+      // Every point of the box is within r of its center
+      const double r = 0.5*node.m_box.sizes().norm();
+      if(r < L.load()+max_error)
+      {
+        const double uN = 
+          dist_to_B(node.m_box.center().transpose(),
+            std::numeric_limits<double>::infinity())+r;
+        if(uN <= L.load()+max_error)
+        {
+          hausdorff_atomic_max(U,uN);
+          return;
+        }
+      }
+      traverse(*node.m_left);
+      traverse(*node.m_right);
+    };
+    // Split the top of the hierarchy into enough subtrees for all threads
+    std::vector<const AABB<Eigen::MatrixXd,3> *> front(1,&treeA);
+    const size_t sthc = std::thread::hardware_concurrency();
+    const size_t min_front = 16*(sthc == 0 ? 8 : sthc);
+    for(bool split = true;split && front.size() < min_front;)
+    {
+      split = false;
+      std::vector<const AABB<Eigen::MatrixXd,3> *> next;
+      for(const auto * node : front)
+      {
+        if(node->is_leaf())
+        {
+          next.push_back(node);
+        }else
+        {
+          next.push_back(node->m_left);
+          next.push_back(node->m_right);
+          split = true;
+        }
+      }
+      front.swap(next);
+    }
+    parallel_for(front.size(),[&](const int n){ traverse(*front[n]); },2);
+    l = L.load();
+    u = std::max(U.load(),l);
+  }
+}
+
+template <
+  typename DerivedVA, 
+  typename DerivedFA,
+  typename DerivedVB,
+  typename DerivedFB,
+  typename Scalar>
+IGL_INLINE bool igl::hausdorff(
+  const Eigen::PlainObjectBase<DerivedVA> & VA, 
+  const Eigen::PlainObjectBase<DerivedFA> & FA,
+  const Eigen::PlainObjectBase<DerivedVB> & VB, 
+  const Eigen::PlainObjectBase<DerivedFB> & FB,
+  const Scalar max_error,
+  Scalar & d,
+  Scalar & error,
+  const int max_depth)
+{
+  assert(VA.cols() == 3 && "VA should contain 3d points");
+  assert(FA.cols() == 3 && "FA should contain triangles");
+  assert(VB.cols() == 3 && "VB should contain 3d points");
+  assert(FB.cols() == 3 && "FB should contain triangles");
+  assert(max_error > 0 && "max_error should be positive");
+  assert(max_depth >= 0 && "max_depth should be non-negative");
+  const Eigen::MatrixXd dVA = VA.template cast<double>();
+  const Eigen::MatrixXi iFA = FA.template cast<int>();
+  const Eigen::MatrixXd dVB = VB.template cast<double>();
+  const Eigen::MatrixXi iFB = FB.template cast<int>();
+  double lab,uab,lba,uba;
+  hausdorff_one_sided(dVA,iFA,dVB,iFB,double(max_error),max_depth,lab,uab);
+  hausdorff_one_sided(dVB,iFB,dVA,iFA,double(max_error),max_depth,lba,uba);
+  d = std::max(lab,lba);
+  error = d < std::numeric_limits<double>::infinity() ? 
+    std::max(uab,uba)-d : 0;
+  // Allow for round off in the bounds
+  return error <= max_error*(1.+1e-10);
+}
+
 template <
   typename DerivedV,
   typename Scalar>
@@ -45,45 +294,16 @@ IGL_INLINE void igl::hausdorff(
   Scalar & l,
   Scalar & u)
 {
-  // e  3-long vector of opposite edge lengths
-  Eigen::Matrix<typename DerivedV::Scalar,1,3> e;
-  // Maximum edge length
-  Scalar e_max = 0;
-  for(int i=0;i<3;i++)
-  {
-    e(i) = (V.row((i+1)%3)-V.row((i+2)%3)).norm();
-    e_max = std::max(e_max,e(i));
-  }
-  // Semiperimeter
-  const Scalar s = (e(0)+e(1)+e(2))*0.5;
-  // Area
-  const Scalar A = sqrt(s*(s-e(0))*(s-e(1))*(s-e(2)));
-  // Circumradius
-  const Scalar R = e(0)*e(1)*e(2)/(4.*A);
-  // inradius
-  const Scalar r = A/s;
-  // Initialize lower bound to ∞
-  l = std::numeric_limits<Scalar>::infinity();
   // d  3-long vector of distance from each corner to B
   Eigen::Matrix<typename DerivedV::Scalar,1,3> d;
-  Scalar u1 = std::numeric_limits<Scalar>::infinity();
-  Scalar u2 = 0;
   for(int i=0;i<3;i++)
   {
     d(i) = dist_to_B(V(i,0),V(i,1),V(i,2));
-    // Lower bound is simply the max over vertex distances
-    l = std::max(d(i),l);
-    // u1 is the minimum of corner distances + maximum adjacent edge 
-    u1 = std::min(u1,d(i) + std::max(e((i+1)%3),e((i+2)%3)));
-    // u2 first takes the maximum over corner distances
-    u2 = std::max(u2,d(i));
   }
-  // u2 is the distance from the circumcenter/midpoint of obtuse edge plus the
-  // largest corner distance 
-  u2 += (s-r>2.*R ? R : 0.5*e_max);
-  u = std::min(u1,u2);
+  hausdorff_triangle_bounds(V,d,l,u);
 }
 
 #ifdef IGL_STATIC_LIBRARY
+template bool igl::hausdorff<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, double, double&, double&, int);
 template void igl::hausdorff<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, double&);
 #endif
@@ -51,6 +51,48 @@ namespace igl
     const Eigen::PlainObjectBase<DerivedVB> & VB, 
     const Eigen::PlainObjectBase<DerivedFB> & FB,
     Scalar & d);
+  // Approximate the Hausdorff distance between mesh (VA,FA) and mesh (VB,FB)
+  // up to a given error, accounting for all points of the surfaces (not just
+  // vertices). In each direction, the triangles of one mesh are traversed
+  // through its AABB hierarchy and their distances are queried in the
+  // hierarchy of the other. Boxes and triangles whose upper bound can not
+  // exceed the current lower bound by more than max_error are pruned; the
+  // others are subdivided adaptively (see the triangle bounds below).
+  // Subtrees are processed in parallel.
+  //
+  // Inputs:
+  //   VA  #VA by 3 list of vertex positions
+  //   FA  #FA by 3 list of face indices into VA
+  //   VB  #VB by 3 list of vertex positions
+  //   FB  #FB by 3 list of face indices into VB
+  //   max_error  positive tolerance on error
+  //   max_depth  maximum number of times a triangle is split into 4 (each
+  //     split halves its edges, so about log2(edge length/max_error)
+  //     levels are needed)
+  // Outputs:
+  //   d  lower bound on the hausdorff distance, attained by some point
+  //   error  certified bound so that the hausdorff distance is in
+  //     [d,d+error]
+  // Returns true if error ≤ max_error (up to floating point round off). If
+  // some triangle reached max_depth before its bounds were tight enough,
+  // error may exceed max_error and false is returned; d and error are still
+  // valid bounds.
+  //
+  template <
+    typename DerivedVA, 
+    typename DerivedFA,
+    typename DerivedVB,
+    typename DerivedFB,
+    typename Scalar>
+  IGL_INLINE bool hausdorff(
+    const Eigen::PlainObjectBase<DerivedVA> & VA, 
+    const Eigen::PlainObjectBase<DerivedFA> & FA,
+    const Eigen::PlainObjectBase<DerivedVB> & VB, 
+    const Eigen::PlainObjectBase<DerivedFB> & FB,
+    const Scalar max_error,
+    Scalar & d,
+    Scalar & error,
+    const int max_depth = 40);
   // Compute lower and upper bounds (l,u) on the Hausdorff distance between a triangle
   // (V) and a pointset (e.g., mesh, triangle soup) given by a distance function
   // handle (dist_to_B).
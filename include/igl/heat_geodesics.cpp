@@ -0,0 +1,212 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "heat_geodesics.h"
+#include "avg_edge_length.h"
+#include "boundary_facets.h"
+#include "cotmatrix.h"
+#include "doublearea.h"
+#include "grad.h"
+#include "massmatrix.h"
+#include "parallel_for.h"
+#include "unique.h"
+#include <cassert>
+#include <cmath>
+
+template <typename DerivedV, typename DerivedF, typename Scalar>
+IGL_INLINE bool igl::heat_geodesics_precompute(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  HeatGeodesicsData<Scalar> & data)
+{
+  // default t value
+  const Scalar h = avg_edge_length(V,F);
+  const Scalar t = h*h;
+  return heat_geodesics_precompute(V,F,t,data);
+}
+
+template <typename DerivedV, typename DerivedF, typename Scalar>
+IGL_INLINE bool igl::heat_geodesics_precompute(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const Scalar t,
+  HeatGeodesicsData<Scalar> & data)
+{
+  typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+  assert(F.cols() == 3 && "Only triangle meshes are supported");
+  Eigen::SparseMatrix<Scalar> L,M;
+  cotmatrix(V,F,L);
+  massmatrix(V,F,MASSMATRIX_TYPE_DEFAULT,M);
+  grad(V,F,data.Grad);
+  data.ng = data.Grad.rows() / F.rows();
+  assert(data.ng == 3);
+  // Integrated divergence: -Grad' * diag(areas) so that Div*Grad = L
+  VectorXS dblA;
+  doublearea(V,F,dblA);
+  const VectorXS TA = (-0.5*dblA).replicate(data.ng,1);
+  data.Div = data.Grad.transpose() * TA.asDiagonal();
+
+  Eigen::MatrixXi O;
+  boundary_facets(F,O);
+  unique(O,data.b);
+
+  const Eigen::SparseMatrix<Scalar> Q = M - t*L;
+  const Eigen::SparseMatrix<Scalar> Aeq;
+  // Heat flow with natural (Neumann) boundary conditions
+  if(!min_quad_with_fixed_precompute(
+    Q,Eigen::VectorXi(),Aeq,true,data.Neumann))
+  {
+    return false;
+  }
+  // Heat flow with zero Dirichlet boundary conditions
+  if(data.b.size() > 0)
+  {
+    if(!min_quad_with_fixed_precompute(Q,data.b,Aeq,true,data.Dirichlet))
+    {
+      return false;
+    }
+  }
+  // Poisson problem. Pinning a single vertex makes -L positive definite (for
+  // a connected mesh) so that this is a Cholesky factorization too. The
+  // constant offset is removed at solve time.
+  const Eigen::SparseMatrix<Scalar> nL = -L;
+  const Eigen::VectorXi pin = Eigen::VectorXi::Zero(1);
+  if(!min_quad_with_fixed_precompute(nL,pin,Aeq,true,data.Poisson))
+  {
+    return false;
+  }
+  return true;
+}
+
+namespace igl
+{
+  // Shared implementation of heat_geodesics_solve and
+  // heat_geodesics_batch_solve.
+  //
+  // Inputs:
+  //   data  precomputation data
+  //   U0  #V by k list of initial heat distributions
+  // Outputs:
+  //   D  #V by k list of distances up to a constant per column
+  template <typename Scalar>
+  IGL_INLINE void heat_geodesics_diffuse_and_integrate(
+    const HeatGeodesicsData<Scalar> & data,
+    const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> & U0,
+    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> & D)
+  {
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixXS;
+    const int k = U0.cols();
+    const MatrixXS Beq;
+    // Heat flow: (M - tL) u = u0
+    MatrixXS U;
+    min_quad_with_fixed_solve(
+      data.Neumann,(-U0).eval(),MatrixXS::Zero(0,k).eval(),Beq,U);
+    if(data.b.size() > 0)
+    {
+      // Average Dirichlet and Neumann solutions
+      MatrixXS UD;
+      min_quad_with_fixed_solve(
+        data.Dirichlet,(-U0).eval(),MatrixXS::Zero(data.b.size(),k).eval(),
+        Beq,UD);
+      U += UD;
+      U *= 0.5;
+    }
+    // Normalized (negated) gradient field: points away from sources
+    MatrixXS X = data.Grad*U;
+    const int m = data.Grad.rows()/data.ng;
+    const int ng = data.ng;
+    parallel_for(m,[&X,&m,&ng,&k](const int f)
+    {
+      for(int c = 0;c<k;c++)
+      {
+        // Far from the sources the gradient is tiny (e.g., 1e-300), so scale
+        // by the max component before taking the norm to avoid underflow.
+        Scalar ma = 0;
+        for(int d = 0;d<ng;d++)
+        {
+          ma = std::max(ma,std::abs(X(d*m+f,c)));
+        }
+        Scalar norm = 0;
+        if(ma > 0)
+        {
+          for(int d = 0;d<ng;d++)
+          {
+            const Scalar xd = X(d*m+f,c)/ma;
+            norm += xd*xd;
+          }
+          norm = ma*std::sqrt(norm);
+        }
+        for(int d = 0;d<ng;d++)
+        {
+          X(d*m+f,c) = (norm == 0 || norm != norm) ? 0 : -X(d*m+f,c)/norm;
+        }
+      }
+    },1000);
+    // Poisson problem: L d = Div X
+    const MatrixXS B = data.Div*X;
+    min_quad_with_fixed_solve(
+      data.Poisson,B,MatrixXS::Zero(1,k).eval(),Beq,D);
+  }
+}
+
+template <typename Scalar, typename Derivedgamma, typename DerivedD>
+IGL_INLINE void igl::heat_geodesics_solve(
+  const HeatGeodesicsData<Scalar> & data,
+  const Eigen::MatrixBase<Derivedgamma> & gamma,
+  Eigen::PlainObjectBase<DerivedD> & D)
+{
+  typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixXS;
+  assert(gamma.size() > 0 && "Need at least one source");
+  const int n = data.Grad.cols();
+  MatrixXS U0 = MatrixXS::Zero(n,1);
+  for(int g = 0;g<gamma.size();g++)
+  {
+    U0(gamma(g),0) = 1;
+  }
+  MatrixXS DS;
+  heat_geodesics_diffuse_and_integrate(data,U0,DS);
+  // Shift so that distance at the sources is (on average) zero
+  Scalar Dgamma = 0;
+  for(int g = 0;g<gamma.size();g++)
+  {
+    Dgamma += DS(gamma(g),0);
+  }
+  Dgamma /= Scalar(gamma.size());
+  D = (DS.col(0).array() - Dgamma).template cast<typename DerivedD::Scalar>();
+}
+
+template <typename Scalar, typename DerivedS, typename DerivedD>
+IGL_INLINE void igl::heat_geodesics_batch_solve(
+  const HeatGeodesicsData<Scalar> & data,
+  const Eigen::MatrixBase<DerivedS> & S,
+  Eigen::PlainObjectBase<DerivedD> & D)
+{
+  typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixXS;
+  const int n = data.Grad.cols();
+  const int k = S.size();
+  MatrixXS U0 = MatrixXS::Zero(n,k);
+  for(int s = 0;s<k;s++)
+  {
+    U0(S(s),s) = 1;
+  }
+  MatrixXS DS;
+  heat_geodesics_diffuse_and_integrate(data,U0,DS);
+  D.resize(n,k);
+  for(int s = 0;s<k;s++)
+  {
+    D.col(s) =
+      (DS.col(s).array() - DS(S(s),s)).template cast<typename DerivedD::Scalar>();
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::heat_geodesics_precompute<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::HeatGeodesicsData<double>&);
+template bool igl::heat_geodesics_precompute<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, double, igl::HeatGeodesicsData<double>&);
+template void igl::heat_geodesics_solve<double, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(igl::HeatGeodesicsData<double> const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
+template void igl::heat_geodesics_batch_solve<double, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(igl::HeatGeodesicsData<double> const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+#endif
@@ -0,0 +1,98 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_HEAT_GEODESICS_H
+#define IGL_HEAT_GEODESICS_H
+#include "igl_inline.h"
+#include "min_quad_with_fixed.h"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+namespace igl
+{
+  template <typename Scalar>
+  struct HeatGeodesicsData
+  {
+    // Grad  #F*ng by #V gradient operator
+    // Div  #V by #F*ng (integrated) divergence operator, so that Div*Grad = L
+    Eigen::SparseMatrix<Scalar> Grad,Div;
+    // Number of gradient components per face
+    int ng;
+    // #b list of boundary vertex indices
+    Eigen::VectorXi b;
+    // Cached factorizations of the heat operator (M - t L) with Neumann and
+    // zero Dirichlet boundary conditions and of the Poisson operator (-L)
+    min_quad_with_fixed_data<Scalar> Neumann,Dirichlet,Poisson;
+    HeatGeodesicsData():
+      Grad(),
+      Div(),
+      ng(0),
+      b(),
+      Neumann(),
+      Dirichlet(),
+      Poisson()
+    {};
+  };
+  // Precompute factorized solvers for computing a fast approximation of
+  // geodesic distances on a mesh (V,F). [Crane et al. 2013]
+  //
+  // Inputs:
+  //   V  #V by 3 list of mesh vertex positions
+  //   F  #F by 3 list of mesh face indices into V
+  // Outputs:
+  //   data  precomputation data (see heat_geodesics_solve)
+  // Returns true on success, false on error
+  //
+  // Known issues: the mesh is assumed to be a single connected component.
+  template <typename DerivedV, typename DerivedF, typename Scalar>
+  IGL_INLINE bool heat_geodesics_precompute(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    HeatGeodesicsData<Scalar> & data);
+  // Inputs:
+  //   t  "heat" parameter (smaller --> more accurate, less stable) {h^2 where h
+  //     is the average edge length}
+  template <typename DerivedV, typename DerivedF, typename Scalar>
+  IGL_INLINE bool heat_geodesics_precompute(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const Scalar t,
+    HeatGeodesicsData<Scalar> & data);
+  // Compute fast approximate geodesic distances using precomputed data from a
+  // set of selected source vertices (gamma). Costs two back-substitutions.
+  //
+  // Inputs:
+  //   data  precomputation data (see heat_geodesics_precompute)
+  //   gamma  #gamma list of indices into V of source vertices
+  // Outputs:
+  //   D  #V list of distances to gamma
+  template <typename Scalar, typename Derivedgamma, typename DerivedD>
+  IGL_INLINE void heat_geodesics_solve(
+    const HeatGeodesicsData<Scalar> & data,
+    const Eigen::MatrixBase<Derivedgamma> & gamma,
+    Eigen::PlainObjectBase<DerivedD> & D);
+  // Compute fast approximate geodesic distances from each of many single
+  // source vertices at once. All sources share the same two multi-column
+  // back-substitutions.
+  //
+  // Inputs:
+  //   data  precomputation data (see heat_geodesics_precompute)
+  //   S  #S list of indices into V of source vertices
+  // Outputs:
+  //   D  #V by #S list of distances, so that D(:,s) are the distances to S(s)
+  template <typename Scalar, typename DerivedS, typename DerivedD>
+  IGL_INLINE void heat_geodesics_batch_solve(
+    const HeatGeodesicsData<Scalar> & data,
+    const Eigen::MatrixBase<DerivedS> & S,
+    Eigen::PlainObjectBase<DerivedD> & D);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#include "heat_geodesics.cpp"
+#endif
+
+#endif
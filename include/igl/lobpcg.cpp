@@ -0,0 +1,267 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "lobpcg.h"
+#include "parallel_for.h"
+#include <Eigen/Dense>
+#include <Eigen/SparseCholesky>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace igl
+{
+  // Call func(c0,w) for contiguous panels of columns [c0,c0+w) covering
+  // cols columns, in parallel if there are enough entries (size)
+  template <typename FuncType>
+  IGL_INLINE void lobpcg_panels(
+    const int cols,
+    const int size,
+    const FuncType & func)
+  {
+    const size_t sthc = std::thread::hardware_concurrency();
+    const int num_panels = std::max(1,std::min(cols,int(sthc==0?8:sthc)));
+    parallel_for(num_panels,[&](const int p)
+    {
+      const int c0 = (p*cols)/num_panels;
+      const int c1 = ((p+1)*cols)/num_panels;
+      if(c1 > c0)
+      {
+        func(c0,c1-c0);
+      }
+    },size < 10000 ? num_panels+1 : 2);
+  }
+}
+
+template <
+  typename Atype,
+  typename Btype,
+  typename DerivedU,
+  typename DerivedS>
+IGL_INLINE bool igl::lobpcg(
+  const Eigen::SparseMatrix<Atype> & A,
+  const Eigen::SparseMatrix<Btype> & iB,
+  const int k,
+  const Atype sigma,
+  Eigen::PlainObjectBase<DerivedU> & U,
+  Eigen::PlainObjectBase<DerivedS> & S)
+{
+  using namespace Eigen;
+  using namespace std;
+  typedef Atype Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixXS;
+  typedef Matrix<Scalar,Dynamic,1> VectorXS;
+  const int n = A.rows();
+  assert(A.cols() == n && "A should be square.");
+  assert(iB.rows() == n && iB.cols() == n && "B should match A's dims.");
+  if(k <= 0 || k > n)
+  {
+    cerr<<"lobpcg: k should be in 1.."<<n<<endl;
+    return false;
+  }
+  const SparseMatrix<Scalar> B = iB.template cast<Scalar>();
+  // Block size: k plus guard vectors, which speed up convergence of the
+  // last wanted pairs
+  const int m = std::min(n,k+std::max(5,k/10));
+  if(n <= std::max(3*m,200))
+  {
+    // Small problem: dense solver
+    const MatrixXS dA = A, dB = B;
+    GeneralizedSelfAdjointEigenSolver<MatrixXS> es(dA,dB);
+    if(es.info() != Success)
+    {
+      cerr<<"lobpcg: dense eigen solver failed"<<endl;
+      return false;
+    }
+    U = es.eigenvectors().leftCols(k).template cast<typename DerivedU::Scalar>();
+    S = es.eigenvalues().head(k).template cast<typename DerivedS::Scalar>();
+    return true;
+  }
+
+  // Shift-and-invert preconditioner, factored once
+  SimplicialLDLT<SparseMatrix<Scalar> > ldlt;
+  ldlt.compute(SparseMatrix<Scalar>(A - sigma*B));
+  if(ldlt.info() != Success)
+  {
+    cerr<<"lobpcg: factorization of A - sigma B failed"<<endl;
+    return false;
+  }
+  const auto multiply =
+    [&n](const SparseMatrix<Scalar> & M, const MatrixXS & X, MatrixXS & Y)
+  {
+    Y.resize(n,X.cols());
+    lobpcg_panels(X.cols(),X.size(),[&](const int c0, const int w)
+    {
+      Y.middleCols(c0,w) = M*X.middleCols(c0,w);
+    });
+  };
+  const auto precondition = [&](const MatrixXS & R, MatrixXS & W)
+  {
+    W.resize(n,R.cols());
+    lobpcg_panels(R.cols(),R.size(),[&](const int c0, const int w)
+    {
+      W.middleCols(c0,w) = ldlt.solve(R.middleCols(c0,w));
+    });
+  };
+  // B-orthonormalize the columns of Y by two passes of SVQB, dropping
+  // (numerically) linearly dependent directions. Also outputs BY = B*Y.
+  const auto svqb = [&](MatrixXS & Y, MatrixXS & BY)
+  {
+    multiply(B,Y,BY);
+    for(int pass = 0;pass<2 && Y.cols()>0;pass++)
+    {
+      MatrixXS G = Y.transpose()*BY;
+      G = (0.5*(G+G.transpose())).eval();
+      const Scalar max_diag = G.diagonal().maxCoeff();
+      if(!(max_diag > 0))
+      {
+        Y.resize(n,0);
+        BY.resize(n,0);
+        return;
+      }
+      const VectorXS d = G.diagonal().cwiseMax(
+        std::numeric_limits<Scalar>::epsilon()*max_diag).cwiseSqrt().cwiseInverse();
+      SelfAdjointEigenSolver<MatrixXS> es(d.asDiagonal()*G*d.asDiagonal());
+      // Eigen values are ascending: keep the well conditioned tail
+      const VectorXS & theta = es.eigenvalues();
+      const Scalar threshold = 1e-12*theta.maxCoeff();
+      int keep = 0;
+      while(keep < theta.size() && theta(theta.size()-1-keep) > threshold)
+      {
+        keep++;
+      }
+      const MatrixXS T = d.asDiagonal()*es.eigenvectors().rightCols(keep)*
+        theta.tail(keep).cwiseSqrt().cwiseInverse().asDiagonal();
+      Y = (Y*T).eval();
+      BY = (BY*T).eval();
+    }
+  };
+  // Rayleigh-Ritz on a B-orthonormal basis X (with AX, BX)
+  VectorXS lambda;
+  const auto rayleigh_ritz = [&](MatrixXS & X, MatrixXS & AX, MatrixXS & BX)
+  {
+    MatrixXS H = X.transpose()*AX;
+    H = (0.5*(H+H.transpose())).eval();
+    SelfAdjointEigenSolver<MatrixXS> es(H);
+    const MatrixXS C = es.eigenvectors().leftCols(m);
+    X = (X*C).eval();
+    AX = (AX*C).eval();
+    BX = (BX*C).eval();
+    lambda = es.eigenvalues().head(m);
+  };
+
+  // Residuals are relative to (cheap upper bounds of) the matrix norms
+  const auto inf_norm = [](const SparseMatrix<Scalar> & M)->Scalar
+  {
+    VectorXS row_sums = VectorXS::Zero(M.rows());
+    for(int c = 0;c<M.outerSize();c++)
+    {
+      for(typename SparseMatrix<Scalar>::InnerIterator it(M,c);it;++it)
+      {
+        row_sums(it.row()) += std::abs(it.value());
+      }
+    }
+    return row_sums.maxCoeff();
+  };
+  const Scalar normA = inf_norm(A);
+  const Scalar normB = inf_norm(B);
+  const Scalar tol = 1e-8;
+  const int max_iter = 500;
+  MatrixXS X = MatrixXS::Random(n,m),AX,BX;
+  svqb(X,BX);
+  if(X.cols() < m)
+  {
+    cerr<<"lobpcg: degenerate initial guess"<<endl;
+    return false;
+  }
+  multiply(A,X,AX);
+  rayleigh_ritz(X,AX,BX);
+  MatrixXS P(n,0),R,W,Y,BY,AY;
+  bool converged = false;
+  for(int iter = 0;iter<max_iter;iter++)
+  {
+    R = AX - BX*lambda.asDiagonal();
+    // Relative residuals and active (unconverged) columns
+    std::vector<int> active;
+    converged = true;
+    for(int j = 0;j<m;j++)
+    {
+      const Scalar scale = (normA + std::abs(lambda(j))*normB)*X.col(j).norm();
+      if(R.col(j).norm() > tol*scale)
+      {
+        active.push_back(j);
+        if(j < k)
+        {
+          converged = false;
+        }
+      }
+    }
+    if(converged)
+    {
+      break;
+    }
+    MatrixXS Ra(n,active.size());
+    for(int a = 0;a<(int)active.size();a++)
+    {
+      Ra.col(a) = R.col(active[a]);
+    }
+    precondition(Ra,W);
+    // Search directions [W P], B-orthogonal to X and B-orthonormalized
+    Y.resize(n,W.cols()+P.cols());
+    Y<<W,P;
+    for(int pass = 0;pass<2;pass++)
+    {
+      Y -= X*(BX.transpose()*Y);
+    }
+    svqb(Y,BY);
+    if(Y.cols() == 0)
+    {
+      break;
+    }
+    multiply(A,Y,AY);
+    // Rayleigh-Ritz on [X Y]
+    const int q = Y.cols();
+    MatrixXS H(m+q,m+q);
+    H.topLeftCorner(m,m) = X.transpose()*AX;
+    H.topRightCorner(m,q) = X.transpose()*AY;
+    H.bottomLeftCorner(q,m) = H.topRightCorner(m,q).transpose();
+    H.bottomRightCorner(q,q) = Y.transpose()*AY;
+    H = (0.5*(H+H.transpose())).eval();
+    SelfAdjointEigenSolver<MatrixXS> es(H);
+    const MatrixXS Cx = es.eigenvectors().topLeftCorner(m,m);
+    const MatrixXS Cy = es.eigenvectors().bottomLeftCorner(q,m);
+    P = Y*Cy;
+    X = (X*Cx + P).eval();
+    AX = (AX*Cx + AY*Cy).eval();
+    BX = (BX*Cx + BY*Cy).eval();
+    lambda = es.eigenvalues().head(m);
+    if(iter % 10 == 9)
+    {
+      // Counter loss of B-orthonormality
+      svqb(X,BX);
+      if(X.cols() < m)
+      {
+        cerr<<"lobpcg: lost rank"<<endl;
+        return false;
+      }
+      multiply(A,X,AX);
+      rayleigh_ritz(X,AX,BX);
+      P.resize(n,0);
+    }
+  }
+  U = X.leftCols(k).template cast<typename DerivedU::Scalar>();
+  S = lambda.head(k).template cast<typename DerivedS::Scalar>();
+  return converged;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::lobpcg<double, double, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::SparseMatrix<double, 0, int> const&, Eigen::SparseMatrix<double, 0, int> const&, const int, const double, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
+#endif
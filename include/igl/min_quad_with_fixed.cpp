@@ -15,14 +15,50 @@
 #include "matlab_format.h"
 #include "EPS.h"
 #include "cat.h"
+#include "parallel_for.h"
 
 //#include <Eigen/SparseExtra>
 // Bug in unsupported/Eigen/SparseExtra needs iostream first
 #include <iostream>
 #include <unsupported/Eigen/SparseExtra>
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <iostream>
+#include <thread>
+
+namespace igl
+{
+  // Minimum number of right-hand side entries (rows times columns) before
+  // columns are back-substituted in parallel
+  const int MIN_QUAD_WITH_FIXED_MIN_PARALLEL = 10000;
+  // Solve with a factorization for all columns of B, splitting the columns
+  // into one contiguous panel per thread. Solvers' solve() is const and
+  // keeps no state, so panels can share the factorization.
+  template <typename Solver, typename DerivedB, typename Derivedsol>
+  IGL_INLINE void min_quad_with_fixed_panel_solve(
+    const Solver & solver,
+    const Eigen::MatrixBase<DerivedB> & B,
+    Eigen::PlainObjectBase<Derivedsol> & sol)
+  {
+    const int cols = B.cols();
+    const size_t sthc = std::thread::hardware_concurrency();
+    const int num_panels =
+      std::max(1,std::min(cols,int(sthc == 0 ? 8 : sthc)));
+    sol.resize(B.rows(),cols);
+    if(num_panels == 1 || B.size() < MIN_QUAD_WITH_FIXED_MIN_PARALLEL)
+    {
+      sol = solver.solve(B);
+      return;
+    }
+    parallel_for(num_panels,[&](const int p)
+    {
+      const int c0 = (p*cols)/num_panels;
+      const int c1 = ((p+1)*cols)/num_panels;
+      sol.middleCols(c0,c1-c0) = solver.solve(B.middleCols(c0,c1-c0));
+    },2);
+  }
+}
 
 template <typename T, typename Derivedknown>
 IGL_INLINE bool igl::min_quad_with_fixed_precompute(
@@ -209,7 +245,14 @@ IGL_INLINE bool igl::min_quad_with_fixed_precompute(
 #ifdef MIN_QUAD_WITH_FIXED_CPP_DEBUG
     cout<<"    factorize"<<endl;
 #endif
-    if(data.Auu_pd && neq == 0)
+    if(data.Auu_pd && neq == 0 && data.use_amg)
+    {
+      if(!amg_precompute(Auu,data.amg))
+      {
+        return false;
+      }
+      data.solver_type = min_quad_with_fixed_data<T>::AMG;
+    }else if(data.Auu_pd && neq == 0)
     {
 #ifdef MIN_QUAD_WITH_FIXED_CPP_DEBUG
     cout<<"    llt"<<endl;
@@ -452,15 +495,26 @@ IGL_INLINE bool igl::min_quad_with_fixed_solve(
     switch(data.solver_type)
     {
       case igl::min_quad_with_fixed_data<T>::LLT:
-        sol = data.llt.solve(NB);
+        min_quad_with_fixed_panel_solve(data.llt,NB,sol);
         break;
       case igl::min_quad_with_fixed_data<T>::LDLT:
-        sol = data.ldlt.solve(NB);
+        min_quad_with_fixed_panel_solve(data.ldlt,NB,sol);
         break;
       case igl::min_quad_with_fixed_data<T>::LU:
         // Not a bottleneck
-        sol = data.lu.solve(NB);
+        min_quad_with_fixed_panel_solve(data.lu,NB,sol);
         break;
+      case igl::min_quad_with_fixed_data<T>::AMG:
+      {
+        MatrixXT amg_sol;
+        if(!amg_solve(data.amg,NB,amg_sol))
+        {
+          cerr<<"Error: AMG did not converge"<<endl;
+          return false;
+        }
+        sol = amg_sol;
+        break;
+      }
       default:
         cerr<<"Error: invalid solver type"<<endl;
         return false;
@@ -502,7 +556,7 @@ IGL_INLINE bool igl::min_quad_with_fixed_solve(
     MatrixXT QRB;
     QRB = -data.AeqTQ2T * (data.Auu * lambda_0) + data.AeqTQ2T * NB;
     Derivedsol lambda;
-    lambda = data.llt.solve(QRB);
+    min_quad_with_fixed_panel_solve(data.llt,QRB,lambda);
     // prepare output
     Derivedsol solu;
     solu = data.AeqTQ2 * lambda + lambda_0;
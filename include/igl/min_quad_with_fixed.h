@@ -8,6 +8,7 @@
 #ifndef IGL_MIN_QUAD_WITH_FIXED_H
 #define IGL_MIN_QUAD_WITH_FIXED_H
 #include "igl_inline.h"
+#include "amg.h"
 
 #define EIGEN_YES_I_KNOW_SPARSE_MODULE_IS_NOT_STABLE_YET
 #include <Eigen/Core>
@@ -43,6 +44,9 @@ namespace igl
   //   Y  list of fixed values corresponding to known rows in Z
   //   Aeq  m by n list of linear equality constraint coefficients
   //   pd flag specifying whether A(unknown,unknown) is positive definite
+  //   data.use_amg  whether to solve positive definite systems without
+  //     equality constraints using algebraic multigrid (see igl::amg_solve)
+  //     rather than a sparse Cholesky factorization {false}
   // Outputs:
   //   data  factorization struct with all necessary information to solve
   //     using min_quad_with_fixed_solve
@@ -61,6 +65,10 @@ namespace igl
     );
   // Solves a system previously factored using min_quad_with_fixed_precompute
   //
+  // All k columns share the factorization, so prefer one call with a k-column
+  // Y (and B) over k single-column calls: the columns are split into panels
+  // that are back-substituted in parallel.
+  //
   // Template:
   //   T  type of sparse matrix (e.g. double)
   //   DerivedY  type of Y (e.g. derived from VectorXd or MatrixXd)
@@ -73,7 +81,8 @@ namespace igl
   // Outputs:
   //   Z  n by k solution
   //   sol  #unknowns+#lagrange by k solution to linear system
-  // Returns true on success, false on error
+  // Returns true on success, false on error (including when data.use_amg and
+  // igl::amg_solve did not reach data.amg.tolerance)
   template <
     typename T,
     typename DerivedB,
@@ -144,8 +153,15 @@ struct igl::min_quad_with_fixed_data
     LDLT = 1,
     LU = 2,
     QR_LLT = 3,
-    NUM_SOLVER_TYPES = 4
+    AMG = 4,
+    NUM_SOLVER_TYPES = 5
   } solver_type;
+  // Set before min_quad_with_fixed_precompute to use AMG instead of LLT for
+  // large positive definite systems, where the fill-in of a factorization
+  // would not fit in memory. data.amg's parameters (e.g., tolerance) can be
+  // tuned in between.
+  bool use_amg = false;
+  igl::AMGData<T> amg;
   // Solvers
   Eigen::SimplicialLLT <Eigen::SparseMatrix<T > > llt;
   Eigen::SimplicialLDLT<Eigen::SparseMatrix<T > > ldlt;
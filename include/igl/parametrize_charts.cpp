@@ -0,0 +1,226 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "parametrize_charts.h"
+#include "boundary_loop.h"
+#include "doublearea.h"
+#include "harmonic.h"
+#include "lscm.h"
+#include "map_vertices_to_circle.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+IGL_INLINE bool igl::parametrize_charts(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const Eigen::VectorXi & C,
+  const ChartParametrizationType type,
+  Eigen::MatrixXd & UV,
+  Eigen::MatrixXi & FUV)
+{
+  using namespace Eigen;
+  assert(F.cols() == 3 && "F should contain triangles");
+  assert(C.size() == F.rows() && "C should have one id per face");
+  const int n = V.rows();
+  const int m = F.rows();
+  const int num_charts = m == 0 ? 0 : C.maxCoeff()+1;
+
+  // Bucket faces by chart
+  std::vector<int> start(num_charts+1,0);
+  for(int f = 0;f<m;f++)
+  {
+    start[C(f)+1]++;
+  }
+  std::partial_sum(start.begin(),start.end(),start.begin());
+  std::vector<int> faces(m);
+  {
+    std::vector<int> cursor(start.begin(),start.end()-1);
+    for(int f = 0;f<m;f++)
+    {
+      faces[cursor[C(f)]++] = f;
+    }
+  }
+  // Largest charts first, so that threads finish at about the same time
+  std::vector<int> order(num_charts);
+  std::iota(order.begin(),order.end(),0);
+  std::stable_sort(order.begin(),order.end(),[&start](const int a, const int b)
+  {
+    return start[a+1]-start[a] > start[b+1]-start[b];
+  });
+
+  const auto parametrize =
+    [&type](const MatrixXd & Vc, const MatrixXi & Fc, MatrixXd & UVc)->bool
+  {
+    VectorXi bnd;
+    igl::boundary_loop(Fc,bnd);
+    switch(type)
+    {
+      case CHART_PARAMETRIZATION_TYPE_HARMONIC:
+      {
+        if(bnd.size() == 0)
+        {
+          return false;
+        }
+        MatrixXd bnd_uv;
+        igl::map_vertices_to_circle(Vc,bnd,bnd_uv);
+        if(!igl::harmonic(Vc,Fc,bnd,bnd_uv,1,UVc))
+        {
+          return false;
+        }
+        // Unit disk to the chart's surface area
+        VectorXd A,Auv;
+        igl::doublearea(Vc,Fc,A);
+        igl::doublearea(UVc,Fc,Auv);
+        const double s = std::sqrt(A.sum()/Auv.cwiseAbs().sum());
+        UVc *= s;
+        break;
+      }
+      case CHART_PARAMETRIZATION_TYPE_LSCM:
+      default:
+      {
+        // Fix the first boundary vertex and the boundary vertex farthest
+        // from it (any vertices if the chart is closed). If the boundary
+        // is collapsed to a point, fall back to the farthest chart vertex.
+        const int b0 = bnd.size() > 0 ? bnd(0) : 0;
+        int b1 = b0;
+        double farthest = 0;
+        const auto find_farthest = [&](const int nb, const bool on_bnd)
+        {
+          for(int i = 0;i<nb;i++)
+          {
+            const int v = on_bnd ? bnd(i) : i;
+            const double d = (Vc.row(v)-Vc.row(b0)).squaredNorm();
+            if(d > farthest)
+            {
+              farthest = d;
+              b1 = v;
+            }
+          }
+        };
+        find_farthest(bnd.size(),true);
+        if(b1 == b0)
+        {
+          find_farthest(Vc.rows(),false);
+        }
+        // All vertices coincide: no scale to pin, report the chart as failed
+        if(b1 == b0)
+        {
+          return false;
+        }
+        VectorXi b(2);
+        b<<b0,b1;
+        MatrixXd bc(2,2);
+        bc<<0,0,std::sqrt(farthest),0;
+        if(!igl::lscm(Vc,Fc,b,bc,UVc))
+        {
+          return false;
+        }
+        break;
+      }
+    }
+    return UVc.allFinite();
+  };
+
+  // Each worker pulls the next chart until none are left
+  std::vector<MatrixXd> chart_UV(num_charts);
+  std::vector<MatrixXi> chart_F(num_charts);
+  std::vector<VectorXi> chart_V(num_charts);
+  std::vector<char> success(num_charts,1);
+  std::atomic<int> next(0);
+  const size_t sthc = std::thread::hardware_concurrency();
+  const int num_workers =
+    std::min(num_charts,int(sthc == 0 ? 8 : sthc));
+  parallel_for(num_workers,[&](const int)
+  {
+    // Buffers reused for all charts of this worker
+    std::vector<int> local(n,-1);
+    std::vector<int> verts;
+    MatrixXd Vc;
+    while(true)
+    {
+      const int o = next++;
+      if(o >= num_charts)
+      {
+        break;
+      }
+      const int c = order[o];
+      const int mc = start[c+1]-start[c];
+      MatrixXi & Fc = chart_F[c];
+      Fc.resize(mc,3);
+      verts.clear();
+      for(int i = 0;i<mc;i++)
+      {
+        for(int k = 0;k<3;k++)
+        {
+          const int v = F(faces[start[c]+i],k);
+          if(local[v] < 0)
+          {
+            local[v] = verts.size();
+            verts.push_back(v);
+          }
+          Fc(i,k) = local[v];
+        }
+      }
+      Vc.resize(verts.size(),V.cols());
+      for(int i = 0;i<(int)verts.size();i++)
+      {
+        Vc.row(i) = V.row(verts[i]);
+        local[verts[i]] = -1;
+      }
+      chart_V[c] = Map<const VectorXi>(verts.data(),verts.size());
+      if(mc == 0)
+      {
+        continue;
+      }
+      success[c] = parametrize(Vc,Fc,chart_UV[c]);
+      if(!success[c])
+      {
+        chart_UV[c].setZero(verts.size(),2);
+      }
+    }
+  },2);
+
+  // Concatenate charts
+  std::vector<int> offset(num_charts+1,0);
+  for(int c = 0;c<num_charts;c++)
+  {
+    offset[c+1] = offset[c]+chart_V[c].size();
+  }
+  UV.resize(offset[num_charts],2);
+  FUV.resize(m,3);
+  bool all = true;
+  for(int c = 0;c<num_charts;c++)
+  {
+    if(!success[c])
+    {
+      std::cerr<<"parametrize_charts: chart "<<c<<" failed"<<std::endl;
+      all = false;
+    }
+  }
+  parallel_for(num_charts,[&](const int c)
+  {
+    if(chart_V[c].size() > 0)
+    {
+      UV.middleRows(offset[c],chart_V[c].size()) = chart_UV[c];
+    }
+    for(int i = 0;i<chart_F[c].rows();i++)
+    {
+      FUV.row(faces[start[c]+i]) = chart_F[c].row(i).array()+offset[c];
+    }
+  },100);
+  return all;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+#endif
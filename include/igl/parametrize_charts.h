@@ -0,0 +1,57 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_PARAMETRIZE_CHARTS_H
+#define IGL_PARAMETRIZE_CHARTS_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+
+namespace igl
+{
+  enum ChartParametrizationType
+  {
+    // Least squares conformal map (see igl::lscm) fixing the first vertex
+    // of the chart's boundary loop and the boundary vertex farthest from it,
+    // at their distance (the farthest chart vertex if the boundary is
+    // collapsed to a point; charts whose vertices all coincide fail)
+    CHART_PARAMETRIZATION_TYPE_LSCM = 0,
+    // Harmonic map with the boundary mapped to a circle (see igl::harmonic,
+    // igl::map_vertices_to_circle), scaled to the chart's surface area
+    CHART_PARAMETRIZATION_TYPE_HARMONIC = 1,
+    NUM_CHART_PARAMETRIZATION_TYPES = 2
+  };
+  // PARAMETRIZE_CHARTS Parametrize each chart of an atlas independently,
+  // e.g., after cutting a mesh into charts (see cut_mesh, seam_edges).
+  // Charts are extracted and solved concurrently, largest first, with each
+  // thread reusing its own buffers; vertices shared by several charts get
+  // one texture coordinate per chart.
+  //
+  // Inputs:
+  //   V  #V by 3 list of mesh vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  //   C  #F list of chart ids in 0..#C-1 (each chart should be a disk)
+  //   type  parametrization of each chart
+  // Outputs:
+  //   UV  #UV by 2 list of texture coordinates
+  //   FUV  #F by 3 list of indices into UV
+  // Returns true if all charts were parametrized, false if some failed
+  // (e.g., closed charts with harmonic, or charts collapsed to a point),
+  // whose coordinates are left zero
+  IGL_INLINE bool parametrize_charts(
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & F,
+    const Eigen::VectorXi & C,
+    const ChartParametrizationType type,
+    Eigen::MatrixXd & UV,
+    Eigen::MatrixXi & FUV);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "parametrize_charts.cpp"
+#endif
+
+#endif
@@ -0,0 +1,463 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "projected_newton.h"
+#include "flip_avoiding_line_search.h"
+#include "parallel_for.h"
+#include "sparse_cached.h"
+#include "Timer.h"
+#include <Eigen/Dense>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+
+namespace igl
+{
+  namespace projected_newton
+  {
+    // Minimum number of elements to evaluate in parallel
+    const int MIN_PARALLEL = 1000;
+
+    // Energy density ψ as a function of the singular values s of the
+    // Jacobian, and optionally its gradient g and Hessian H w.r.t. s
+    template <int d>
+    IGL_INLINE double density(
+      const ProjectedNewtonData::ENERGY type,
+      const Eigen::Matrix<double,d,1> & s,
+      Eigen::Matrix<double,d,1> & g,
+      Eigen::Matrix<double,d,d> & H)
+    {
+      H.setZero();
+      switch(type)
+      {
+        case ProjectedNewtonData::SYMMETRIC_DIRICHLET:
+        {
+          const Eigen::Array<double,d,1> s2 = s.array().square();
+          g = 2.*s.array() - 2./(s2*s.array());
+          H.diagonal() = 2. + 6./(s2*s2);
+          return (s2 + 1./s2).sum();
+        }
+        case ProjectedNewtonData::ARAP:
+        {
+          g = 2.*(s.array()-1.);
+          H.diagonal().setConstant(2.);
+          return (s.array()-1.).square().sum();
+        }
+        case ProjectedNewtonData::CONFORMAL:
+        {
+          // ψ = c·S with S = Σ sᵢ², c = Π sᵢ^(-2/d) / d
+          const double S = s.squaredNorm();
+          const double c = std::pow(s.prod(),-2./d)/d;
+          for(int i = 0;i<d;i++)
+          {
+            g(i) = c*(2.*s(i) - (2./d)*S/s(i));
+            H(i,i) = c*(2. - 8./d + (4./(d*d) + 2./d)*S/(s(i)*s(i)));
+            for(int j = 0;j<d;j++)
+            {
+              if(j != i)
+              {
+                H(i,j) = c*(
+                  -(4./d)*(s(i)/s(j) + s(j)/s(i)) + (4./(d*d))*S/(s(i)*s(j)));
+              }
+            }
+          }
+          return c*S;
+        }
+        default:
+          assert(false && "Unknown energy");
+          return 0;
+      }
+    }
+
+    // Energy density of a Jacobian J, and optionally its gradient P (vec(dψ/dJ))
+    // and positive semi-definite projected Hessian Hp w.r.t. vec(J)
+    // (column-major). Inverted elements have infinite energy.
+    template <int d>
+    IGL_INLINE double element(
+      const ProjectedNewtonData::ENERGY type,
+      const Eigen::Matrix<double,d,d> & J,
+      Eigen::Matrix<double,d*d,1> * P,
+      Eigen::Matrix<double,d*d,d*d> * Hp)
+    {
+      typedef Eigen::Matrix<double,d,d> MatrixDD;
+      typedef Eigen::Matrix<double,d,1> VectorD;
+      if(!(J.determinant() > 0))
+      {
+        return std::numeric_limits<double>::infinity();
+      }
+      Eigen::JacobiSVD<MatrixDD> svd(J,Eigen::ComputeFullU|Eigen::ComputeFullV);
+      MatrixDD U = svd.matrixU();
+      MatrixDD V = svd.matrixV();
+      VectorD s = svd.singularValues();
+      // Rotation-variant SVD: det(J) > 0 so both or neither need fixing
+      if(U.determinant() < 0)
+      {
+        U.col(d-1) *= -1;
+        s(d-1) *= -1;
+      }
+      if(V.determinant() < 0)
+      {
+        V.col(d-1) *= -1;
+        s(d-1) *= -1;
+      }
+      VectorD g;
+      MatrixDD Hs;
+      const double e = density<d>(type,s,g,Hs);
+      if(P)
+      {
+        const MatrixDD Pm = U*g.asDiagonal()*V.transpose();
+        *P = Eigen::Map<const Eigen::Matrix<double,d*d,1> >(Pm.data());
+      }
+      if(Hp)
+      {
+        // Eigensystem of the Hessian: d scaling modes U diag(w) V' from the
+        // Hessian w.r.t. s and, per pair of singular values, a twist and a
+        // flip mode [Smith et al. 2019]. Clamp negative eigenvalues.
+        Hp->setZero();
+        const auto add_mode = [&](const MatrixDD & A, const double lambda)
+        {
+          if(lambda > 0)
+          {
+            const MatrixDD Q = U*A*V.transpose();
+            const Eigen::Map<const Eigen::Matrix<double,d*d,1> > q(Q.data());
+            *Hp += lambda*q*q.transpose();
+          }
+        };
+        Eigen::SelfAdjointEigenSolver<MatrixDD> es(Hs);
+        for(int k = 0;k<d;k++)
+        {
+          add_mode(
+            MatrixDD(es.eigenvectors().col(k).asDiagonal()),es.eigenvalues()(k));
+        }
+        for(int i = 0;i<d;i++)
+        {
+          for(int j = i+1;j<d;j++)
+          {
+            MatrixDD A = MatrixDD::Zero();
+            A(i,j) = std::sqrt(0.5);
+            A(j,i) = -std::sqrt(0.5);
+            add_mode(A,(g(i)+g(j))/(s(i)+s(j)));
+            A(j,i) = std::sqrt(0.5);
+            const double ds = s(i)-s(j);
+            // (gᵢ - gⱼ)/(sᵢ - sⱼ) → Hᵢᵢ - Hᵢⱼ as sᵢ → sⱼ
+            add_mode(A,
+              std::abs(ds) > 1e-8*(std::abs(s(i))+std::abs(s(j))) ?
+                (g(i)-g(j))/ds : Hs(i,i)-Hs(i,j));
+          }
+        }
+      }
+      return e;
+    }
+
+    // Total energy of the map U and optionally its gradient w.r.t. the free
+    // degrees of freedom and the element Hessians (#F blocks of
+    // dim*(dim+1) by dim*(dim+1), column-major)
+    template <int d>
+    IGL_INLINE double evaluate(
+      const ProjectedNewtonData & data,
+      const Eigen::MatrixXd & U,
+      Eigen::VectorXd * grad,
+      std::vector<double> * Hbuf)
+    {
+      const int nx = d*(d+1);
+      const int K = nx*nx;
+      const int m = data.F.rows();
+      const int n = U.rows();
+      Eigen::VectorXd E(m);
+      Eigen::MatrixXd Ge;
+      if(grad)
+      {
+        Ge.resize(m,nx);
+      }
+      if(Hbuf)
+      {
+        Hbuf->resize(size_t(m)*K);
+      }
+      parallel_for(m,[&](const int f)
+      {
+        Eigen::Matrix<double,d,d> J = Eigen::Matrix<double,d,d>::Zero();
+        for(int r = 0;r<d;r++)
+        {
+          for(int c = 0;c<d;c++)
+          {
+            for(int k = 0;k<d+1;k++)
+            {
+              J(r,c) += U(data.F(f,k),r)*data.G(f,c*(d+1)+k);
+            }
+          }
+        }
+        Eigen::Matrix<double,d*d,1> P;
+        Eigen::Matrix<double,d*d,d*d> Hj;
+        E(f) = data.M(f)*element<d>(
+          data.energy_type,J,grad?&P:nullptr,Hbuf?&Hj:nullptr);
+        if(!grad && !Hbuf)
+        {
+          return;
+        }
+        // vec(J) = B x where x(r*(d+1)+k) is coordinate r of corner k
+        Eigen::Matrix<double,d*d,nx> B = Eigen::Matrix<double,d*d,nx>::Zero();
+        for(int r = 0;r<d;r++)
+        {
+          for(int c = 0;c<d;c++)
+          {
+            for(int k = 0;k<d+1;k++)
+            {
+              B(c*d+r,r*(d+1)+k) = data.G(f,c*(d+1)+k);
+            }
+          }
+        }
+        if(grad)
+        {
+          Ge.row(f) = data.M(f)*(B.transpose()*P).transpose();
+        }
+        if(Hbuf)
+        {
+          Eigen::Map<Eigen::Matrix<double,nx,nx> >(Hbuf->data()+size_t(f)*K) =
+            data.M(f)*B.transpose()*Hj*B;
+        }
+      },MIN_PARALLEL);
+      if(grad)
+      {
+        grad->setZero(data.num_free);
+        for(int f = 0;f<m;f++)
+        {
+          for(int r = 0;r<d;r++)
+          {
+            for(int k = 0;k<d+1;k++)
+            {
+              const int i = data.free_index(r*n+data.F(f,k));
+              if(i >= 0)
+              {
+                (*grad)(i) += Ge(f,r*(d+1)+k);
+              }
+            }
+          }
+        }
+      }
+      return E.sum();
+    }
+
+    IGL_INLINE double evaluate(
+      const ProjectedNewtonData & data,
+      const Eigen::MatrixXd & U,
+      Eigen::VectorXd * grad,
+      std::vector<double> * Hbuf)
+    {
+      return data.dim == 2 ?
+        evaluate<2>(data,U,grad,Hbuf) : evaluate<3>(data,U,grad,Hbuf);
+    }
+  }
+}
+
+IGL_INLINE void igl::projected_newton_precompute(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const Eigen::MatrixXd & U0,
+  const ProjectedNewtonData::ENERGY energy_type,
+  const Eigen::VectorXi & b,
+  const Eigen::MatrixXd & bc,
+  ProjectedNewtonData & data)
+{
+  assert((F.cols() == 3 || F.cols() == 4) && "F should be triangles or tets");
+  const int d = F.cols()-1;
+  assert(U0.cols() == d && "U0 should have F.cols()-1 columns");
+  assert(b.size() == bc.rows());
+  const int n = V.rows();
+  const int m = F.rows();
+  data.V = V;
+  data.F = F;
+  data.dim = d;
+  data.energy_type = energy_type;
+  data.b = b;
+  data.bc = bc;
+  data.U = U0;
+  for(int i = 0;i<b.size();i++)
+  {
+    data.U.row(b(i)) = bc.row(i);
+  }
+
+  // Rest shape: inverse of the rest edge matrix in a local frame
+  data.M.resize(m);
+  data.G.resize(m,d*(d+1));
+  parallel_for(m,[&](const int f)
+  {
+    Eigen::MatrixXd Dm(d,d);
+    if(d == 2)
+    {
+      const Eigen::RowVector3d e1 = V.row(F(f,1))-V.row(F(f,0));
+      const Eigen::RowVector3d e2 = V.row(F(f,2))-V.row(F(f,0));
+      const Eigen::RowVector3d x = e1.normalized();
+      const Eigen::RowVector3d normal = e1.cross(e2);
+      const Eigen::RowVector3d y = normal.normalized().cross(x);
+      Dm<<e1.norm(),e2.dot(x),
+          0,e2.dot(y);
+      data.M(f) = 0.5*normal.norm();
+    }else
+    {
+      for(int k = 0;k<d;k++)
+      {
+        Dm.col(k) = (V.row(F(f,k+1))-V.row(F(f,0))).transpose();
+      }
+      data.M(f) = std::abs(Dm.determinant())/6.;
+    }
+    const Eigen::MatrixXd Dminv = Dm.inverse();
+    for(int c = 0;c<d;c++)
+    {
+      data.G(f,c*(d+1)) = -Dminv.col(c).sum();
+      for(int k = 1;k<d+1;k++)
+      {
+        data.G(f,c*(d+1)+k) = Dminv(k-1,c);
+      }
+    }
+  },projected_newton::MIN_PARALLEL);
+  data.total_measure = data.M.sum();
+
+  // Free degrees of freedom (column-major as in U)
+  data.free_index = Eigen::VectorXi::Zero(n*d);
+  for(int i = 0;i<b.size();i++)
+  {
+    for(int r = 0;r<d;r++)
+    {
+      data.free_index(r*n+b(i)) = -1;
+    }
+  }
+  data.num_free = 0;
+  for(int i = 0;i<n*d;i++)
+  {
+    if(data.free_index(i) >= 0)
+    {
+      data.free_index(i) = data.num_free++;
+    }
+  }
+
+  // Hessian sparsity pattern: every free-free pair of element degrees of
+  // freedom, plus the diagonal (entry -1) for regularization
+  const int nx = d*(d+1);
+  std::vector<Eigen::Triplet<double> > IJV;
+  IJV.reserve(size_t(m)*nx*nx+data.num_free);
+  std::vector<int> entry;
+  entry.reserve(IJV.capacity());
+  for(int f = 0;f<m;f++)
+  {
+    for(int a = 0;a<nx;a++)
+    {
+      const int i = data.free_index((a/(d+1))*n+F(f,a%(d+1)));
+      if(i < 0)
+      {
+        continue;
+      }
+      for(int c = 0;c<nx;c++)
+      {
+        const int j = data.free_index((c/(d+1))*n+F(f,c%(d+1)));
+        if(j < 0)
+        {
+          continue;
+        }
+        IJV.emplace_back(i,j,1);
+        entry.push_back(f*nx*nx+a*nx+c);
+      }
+    }
+  }
+  for(int i = 0;i<data.num_free;i++)
+  {
+    IJV.emplace_back(i,i,1);
+    entry.push_back(-1);
+  }
+  data.H_entry = Eigen::Map<const Eigen::VectorXi>(entry.data(),entry.size());
+  data.H.resize(data.num_free,data.num_free);
+  igl::sparse_cached_precompute(IJV,data.H_cache,data.H);
+  data.has_analyzed_pattern = false;
+  data.stats.clear();
+  data.energy =
+    projected_newton::evaluate(data,data.U,nullptr,nullptr)/data.total_measure;
+}
+
+IGL_INLINE Eigen::MatrixXd igl::projected_newton_solve(
+  ProjectedNewtonData & data,
+  const int iter_num)
+{
+  const int n = data.U.rows();
+  const int d = data.dim;
+  igl::Timer timer;
+  std::vector<double> Hbuf;
+  Eigen::VectorXd grad,values(data.H_entry.size());
+  for(int iter = 0;iter<iter_num;iter++)
+  {
+    ProjectedNewtonData::IterationStats stats;
+    timer.start();
+    const double E =
+      projected_newton::evaluate(data,data.U,&grad,&Hbuf);
+    parallel_for(data.H_entry.size(),[&](const int t)
+    {
+      values(t) = data.H_entry(t) < 0 ? 0 : Hbuf[data.H_entry(t)];
+    },10000);
+    igl::sparse_cached(values,data.H_cache,data.H);
+    stats.gradient_norm = grad.norm();
+    stats.assembly_time = timer.getElapsedTimeInSec();
+
+    timer.start();
+    double mu = data.regularization*data.H.diagonal().mean();
+    if(!(mu > 0))
+    {
+      mu = data.regularization;
+    }
+    Eigen::VectorXd shift = Eigen::VectorXd::Constant(data.num_free,mu);
+    data.H.diagonal() += shift;
+    if(!data.has_analyzed_pattern)
+    {
+      data.llt.analyzePattern(data.H);
+      data.has_analyzed_pattern = true;
+    }
+    data.llt.factorize(data.H);
+    // Projection makes H PSD; numerical trouble is fixed by more damping
+    for(int tries = 0;data.llt.info() != Eigen::Success && tries<10;tries++)
+    {
+      data.H.diagonal() += 9.*shift;
+      shift *= 10.;
+      data.llt.factorize(data.H);
+    }
+    if(data.llt.info() != Eigen::Success)
+    {
+      std::cerr<<"projected_newton_solve: factorization failed"<<std::endl;
+      break;
+    }
+    const Eigen::VectorXd dx = -data.llt.solve(grad);
+    Eigen::MatrixXd dst = data.U;
+    for(int r = 0;r<d;r++)
+    {
+      for(int v = 0;v<n;v++)
+      {
+        const int i = data.free_index(r*n+v);
+        if(i >= 0)
+        {
+          dst(v,r) += dx(i);
+        }
+      }
+    }
+    stats.solve_time = timer.getElapsedTimeInSec();
+
+    timer.start();
+    std::function<double(Eigen::MatrixXd &)> energy =
+      [&data](Eigen::MatrixXd & U)
+      {
+        return projected_newton::evaluate(data,U,nullptr,nullptr);
+      };
+    const double E_new =
+      igl::flip_avoiding_line_search(data.F,data.U,dst,energy,E);
+    stats.line_search_time = timer.getElapsedTimeInSec();
+    data.energy = E_new/data.total_measure;
+    stats.energy = data.energy;
+    data.stats.push_back(stats);
+    if(!(E_new < E))
+    {
+      break;
+    }
+  }
+  return data.U;
+}
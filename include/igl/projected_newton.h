@@ -0,0 +1,127 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_PROJECTED_NEWTON_H
+#define IGL_PROJECTED_NEWTON_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <vector>
+
+namespace igl
+{
+  // Minimize a per-element distortion energy of a map of a triangle mesh into
+  // the plane (parametrization) or of a tet mesh into space (deformation)
+  // with Newton's method, where each element's Hessian is projected to be
+  // positive semi-definite [Teran et al. 2005]. The projection uses the
+  // analytic eigensystem of isotropic energies in terms of the singular
+  // values of the element's Jacobian [Smith et al. 2019], so each
+  // element costs one small SVD. Steps are taken with
+  // flip_avoiding_line_search, so an injective initial map stays injective.
+  //
+  // Compared to slim (a proxy Hessian), each iteration is more expensive but
+  // far fewer are needed. Close to the solution, convergence can drop to
+  // linear where the projection clamps negative twist eigenvalues (e.g.,
+  // compressed triangles).
+  struct ProjectedNewtonData
+  {
+    // Input
+    Eigen::MatrixXd V; // #V by 3 list of rest vertex positions
+    Eigen::MatrixXi F; // #F by 3/4 list of triangles/tets
+    enum ENERGY
+    {
+      // |J|² + |J⁻¹|²
+      SYMMETRIC_DIRICHLET,
+      // |J - R|², R closest rotation
+      ARAP,
+      // |J|²/(dim·det(J)^(2/dim))
+      CONFORMAL
+    };
+    ENERGY energy_type;
+    // Optional input: fixed vertices and their positions
+    Eigen::VectorXi b;
+    Eigen::MatrixXd bc;
+    // Multiple of the average diagonal added to the Hessian, making it
+    // positive definite when there are no fixed vertices
+    double regularization = 1e-8;
+
+    // Timings (in seconds) and progress of one projected_newton_solve
+    // iteration
+    struct IterationStats
+    {
+      double assembly_time = 0; // gradient and projected Hessian
+      double solve_time = 0; // factorization and back-substitution
+      double line_search_time = 0;
+      double gradient_norm = 0; // before the step
+      double energy = 0; // after the step
+    };
+    std::vector<IterationStats> stats;
+
+    // Output
+    Eigen::MatrixXd U; // #V by dim list of mapped vertex positions
+    double energy; // energy divided by total rest area/volume
+
+    // INTERNAL
+    int dim;
+    // #F list of rest areas/volumes
+    Eigen::VectorXd M;
+    double total_measure;
+    // #F by dim*(dim+1): G(f,c*(dim+1)+k) is the derivative of any row of
+    // the Jacobian's column c w.r.t. the same coordinate of corner k
+    Eigen::MatrixXd G;
+    // #V*dim list of indices into free degrees of freedom (-1 if fixed)
+    Eigen::VectorXi free_index;
+    int num_free;
+    // Cached assembly: value t of the Hessian's triplets is entry (a,c) of
+    // element f's Hessian, H_entry(t) = f*nx*nx + a*nx + c with
+    // nx = dim*(dim+1), or -1 for the diagonal
+    Eigen::VectorXi H_entry;
+    Eigen::VectorXi H_cache;
+    Eigen::SparseMatrix<double> H;
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double> > llt;
+    bool has_analyzed_pattern;
+  };
+
+  // Compute the rest shape, fixed degrees of freedom and Hessian sparsity
+  // pattern.
+  //
+  // Inputs:
+  //   V  #V by 3 list of rest vertex positions
+  //   F  #F by 3 list of triangles (map into the plane) or #F by 4 list of
+  //     tets (map into space)
+  //   U0  #V by dim initial map without flipped elements (dim = 2 for
+  //     triangles, 3 for tets)
+  //   energy_type  distortion energy to minimize
+  //   b  #b list of fixed vertex indices
+  //   bc  #b by dim list of their positions
+  // Outputs:
+  //   data  precomputation for projected_newton_solve
+  IGL_INLINE void projected_newton_precompute(
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & F,
+    const Eigen::MatrixXd & U0,
+    const ProjectedNewtonData::ENERGY energy_type,
+    const Eigen::VectorXi & b,
+    const Eigen::MatrixXd & bc,
+    ProjectedNewtonData & data);
+  // Run iter_num projected Newton iterations (stops early once a step does
+  // not decrease the energy)
+  //
+  // Inputs:
+  //   data  precomputation from projected_newton_precompute
+  //   iter_num  maximum number of iterations
+  // Returns data.U, the map after the iterations
+  IGL_INLINE Eigen::MatrixXd projected_newton_solve(
+    ProjectedNewtonData & data,
+    const int iter_num);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "projected_newton.cpp"
+#endif
+
+#endif
@@ -29,6 +29,8 @@ namespace igl
   //   % remap faces
   //   SF = SVJ(F);
   //
+  // See also: weld_and_compact
+  //
   template <
     typename DerivedV, 
     typename DerivedSV, 
@@ -6,8 +6,11 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "remove_unreferenced.h"
-#include "slice.h"
+#include "parallel_for.h"
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 template <
   typename DerivedV,
@@ -44,10 +47,19 @@ IGL_INLINE void igl::remove_unreferenced(
   using namespace std;
   const size_t n = V.rows();
   remove_unreferenced(n,F,I,J);
-  NF = F;
-  std::for_each(NF.data(),NF.data()+NF.size(),
-    [&I](typename DerivedNF::Scalar & a){a=I(a);});
-  slice(V,J,1,NV);
+  NF.resize(F.rows(),F.cols());
+  parallel_for(F.rows(),[&F,&NF,&I](const int f)
+  {
+    for(int c = 0;c<F.cols();c++)
+    {
+      NF(f,c) = F(f,c) == -1 ? -1 : I(F(f,c));
+    }
+  },10000);
+  NV.resize(J.rows(),V.cols());
+  parallel_for(J.rows(),[&V,&NV,&J](const int j)
+  {
+    NV.row(j) = V.row(J(j));
+  },10000);
 }
 
 template <
@@ -60,41 +72,41 @@ IGL_INLINE void igl::remove_unreferenced(
   Eigen::PlainObjectBase<DerivedI> &I,
   Eigen::PlainObjectBase<DerivedJ> &J)
 {
-  // Mark referenced vertices
-  typedef Eigen::Matrix<bool,Eigen::Dynamic,1> MatrixXb;
-  MatrixXb mark = MatrixXb::Zero(n,1);
-  for(int i=0; i<F.rows(); ++i)
+  // Mark referenced vertices (in parallel, concurrent marks of the same
+  // vertex are harmless)
+  std::unique_ptr<std::atomic<bool>[]> mark(new std::atomic<bool>[n]);
+  parallel_for(n,[&mark](const size_t i)
+  {
+    mark[i].store(false,std::memory_order_relaxed);
+  },10000ul);
+  parallel_for(F.rows(),[&F,&mark](const int i)
   {
     for(int j=0; j<F.cols(); ++j)
     {
       if (F(i,j) != -1)
       {
-        mark(F(i,j)) = 1;
+        mark[F(i,j)].store(true,std::memory_order_relaxed);
       }
     }
-  }
-
-  // Sum the occupied cells
-  int newsize = mark.count();
-
-  I.resize(n,1);
-  J.resize(newsize,1);
+  },10000);
 
   // Do a pass on the marked vector and remove the unreferenced vertices
-  int count = 0;
-  for(int i=0;i<mark.rows();++i)
+  I.resize(n,1);
+  std::vector<typename DerivedJ::Scalar> vJ;
+  for(size_t i=0;i<n;++i)
   {
-    if (mark(i) == 1)
+    if (mark[i].load(std::memory_order_relaxed))
     {
-      I(i) = count;
-      J(count) = i;
-      count++;
+      I(i) = vJ.size();
+      vJ.push_back(i);
     }
     else
     {
       I(i) = -1;
     }
   }
+  J.resize(vJ.size(),1);
+  std::copy(vJ.begin(),vJ.end(),J.data());
 }
 
 #ifdef IGL_STATIC_LIBRARY
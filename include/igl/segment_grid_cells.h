@@ -0,0 +1,103 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_SEGMENT_GRID_CELLS_H
+#define IGL_SEGMENT_GRID_CELLS_H
+#include "igl_inline.h"
+#include <cstdint>
+
+namespace igl
+{
+  // SEGMENT_GRID_CELLS Visit the cells of a uniform 2D grid that a segment,
+  // widened by a margin, may overlap. Cells are visited column by column, at
+  // most once each, so that the number of visited cells is proportional to
+  // the length of the segment (plus margin) over the cell size.
+  //
+  // The traversal is conservative as long as the margin covers rounding
+  // error in the (floating point) endpoints: every cell within (L∞) distance
+  // margin of the segment is visited.
+  //
+  // Inputs:
+  //   ax,ay  segment source
+  //   bx,by  segment destination
+  //   ox,oy  grid origin: cell (i,j) is [ox+i*h,ox+(i+1)*h) × [oy+j*h,oy+(j+1)*h)
+  //   h  cell size
+  //   margin  non-negative amount to widen the segment by
+  //   func  function handle taking cell indices i and j as only arguments
+  template<typename FunctionType>
+  inline void segment_grid_cells(
+    const double ax,
+    const double ay,
+    const double bx,
+    const double by,
+    const double ox,
+    const double oy,
+    const double h,
+    const double margin,
+    const FunctionType & func);
+  // Pack cell indices into a single key, e.g., for hashing
+  //
+  // Inputs:
+  //   i,j  cell indices
+  // Returns key unique to (i,j)
+  inline std::int64_t segment_grid_cells_key(const int i, const int j);
+}
+
+// Implementation
+
+#include <algorithm>
+#include <cmath>
+
+template<typename FunctionType>
+inline void igl::segment_grid_cells(
+  const double ax,
+  const double ay,
+  const double bx,
+  const double by,
+  const double ox,
+  const double oy,
+  const double h,
+  const double margin,
+  const FunctionType & func)
+{
+  const double min_x = std::min(ax,bx);
+  const double max_x = std::max(ax,bx);
+  const double min_y = std::min(ay,by);
+  const double max_y = std::max(ay,by);
+  const int i0 = int(std::floor((min_x-margin-ox)/h));
+  const int i1 = int(std::floor((max_x+margin-ox)/h));
+  for(int i = i0;i<=i1;i++)
+  {
+    // Part of the segment within margin of this column
+    const double x0 = std::max(ox+i*h-margin,min_x);
+    const double x1 = std::min(ox+(i+1)*h+margin,max_x);
+    double y0 = min_y;
+    double y1 = max_y;
+    if(x0 <= x1 && ax != bx)
+    {
+      const double s = (by-ay)/(bx-ax);
+      const double yx0 = ay+(x0-ax)*s;
+      const double yx1 = ay+(x1-ax)*s;
+      // Clamping guards against round off beyond the endpoints
+      y0 = std::max(std::min(yx0,yx1),min_y);
+      y1 = std::min(std::max(yx0,yx1),max_y);
+    }
+    const int j0 = int(std::floor((y0-margin-oy)/h));
+    const int j1 = int(std::floor((y1+margin-oy)/h));
+    for(int j = j0;j<=j1;j++)
+    {
+      func(i,j);
+    }
+  }
+}
+
+inline std::int64_t igl::segment_grid_cells_key(const int i, const int j)
+{
+  return (std::int64_t(i)<<32) ^ std::int64_t(std::uint32_t(j));
+}
+
+#endif
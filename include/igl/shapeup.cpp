@@ -11,7 +11,9 @@
 #include <igl/igl_inline.h>
 #include <igl/setdiff.h>
 #include <igl/cat.h>
+#include <igl/AndersonAcceleration.h>
 #include <Eigen/Core>
+#include <limits>
 #include <vector>
 
 namespace igl
@@ -196,31 +198,68 @@ namespace igl
         cout<<"**********************************************************************************************"<<endl;
     }
     projP.conservativeResize(sudata.SC.rows(), 3*sudata.SC.maxCoeff());
-    for (int iter=0;iter<sudata.maxIterations;iter++){
-      
+    
+    //local step: projecting P and constructing the projection part of the (DShape rows of the) right hand side
+    auto localStep=[&](const MatrixXd& currP){
       local_projection(currP, sudata.SC,sudata.S,projP);
-            
-      //constructing the projection part of the (DShape rows of the) right hand side
+      
       int currRow=0;
       for (int i=0;i<sudata.S.rows();i++)
         for (int j=0;j<sudata.SC(i);j++)
           rhs.row(currRow++)=projP.block(i, 3*j, 1,3);
+    };
+    
+    //the energy |W^(1/2)(A*P-rhs)|^2 that both steps decrease, with the rhs of the last local step
+    auto energy=[&](const MatrixXd& currP)->double{
+      MatrixXd residual=sudata.A*currP-rhs;
+      return (residual.array()*(sudata.W*residual).array()).sum();
+    };
+    
+    const bool accelerate=sudata.andersonWindow>0;
+    AndersonAcceleration<double> aa;
+    MatrixXd plainP;
+    double prevEnergy=std::numeric_limits<double>::infinity();
+    for (int iter=0;iter<sudata.maxIterations;iter++){
+      
+      localStep(currP);
       
-      Eigen::PlainObjectBase<DerivedP> lsrhs=-sudata.At*sudata.W*rhs;
+      if (accelerate && iter>0){
+        double currEnergy=energy(currP);
+        if (currEnergy>prevEnergy){
+          //the accelerated iterate is worse; falling back to the plain one
+          currP=plainP;
+          aa.restart(Map<const VectorXd>(currP.data(), currP.size()));
+          localStep(currP);
+          currEnergy=energy(currP);
+          if (!quietIterations)
+            cout << "Iteration "<<iter<<", Anderson step rejected"<<endl;
+        } else if (!quietIterations)
+          cout << "Iteration "<<iter<<", Anderson step accepted"<<endl;
+        prevEnergy=currEnergy;
+      }
+      prevP=currP;
+      
+      DerivedP lsrhs=-sudata.At*sudata.W*rhs;
       MatrixXd Y(0,3), Beq(0,3);  //We do not use the min_quad_solver fixed variables mechanism; they are treated with the closeness energy of ShapeUp.
       min_quad_with_fixed_solve(sudata.solver_data, lsrhs,Y,Beq,currP);
       
       double currChange=(currP-prevP).lpNorm<Infinity>();
       if (!quietIterations)
         cout << "Iteration "<<iter<<", integration Linf error: "<<currChange<< endl;
-      prevP=currP;
+      if (accelerate){
+        if (iter==0)
+          aa.init(sudata.andersonWindow, Map<const VectorXd>(prevP.data(), prevP.size()));
+        plainP=currP;
+        const VectorXd& x=aa.compute(Map<const VectorXd>(currP.data(), currP.size()));
+        currP=Map<const MatrixXd>(x.data(), currP.rows(), currP.cols());
+      }
       if (currChange<sudata.pTolerance){
-        P=currP;
+        P=(accelerate ? plainP : currP);
         return true;
       }
     }
     
-    P=currP;
+    P=(accelerate ? plainP : currP);
     return false;  //we went over maxIterations
     
   }
@@ -33,6 +33,7 @@ namespace igl
     int maxIterations; //referring to number of local-global pairs.
     double pTolerance;   //algorithm stops when max(|P_k-P_{k-1}|)<pTolerance.
     double shapeCoeff, closeCoeff, smoothCoeff;
+    int andersonWindow;  //if >0, accelerates the local-global iterations with Anderson acceleration using this window size (see AndersonAcceleration.h). Accelerated iterates that increase the energy are rejected.
           
     //Internally-used matrices
     Eigen::SparseMatrix<double> DShape, DClose, DSmooth, Q, A, At, W;
@@ -44,7 +45,8 @@ namespace igl
     pTolerance(10e-6),
     shapeCoeff(1.0),
     closeCoeff(100.0),
-    smoothCoeff(0.0){}
+    smoothCoeff(0.0),
+    andersonWindow(0){}
   };
       
   //Every function here defines a local projection for ShapeUp, and must have the following structure to qualify:
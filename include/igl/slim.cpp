@@ -32,7 +32,6 @@
 
 #include <Eigen/IterativeLinearSolvers>
 #include <Eigen/SparseCholesky>
-#include <Eigen/IterativeLinearSolvers>
 
 #include "Timer.h"
 #include "sparse_cached.h"
@@ -67,7 +66,8 @@ namespace igl
                                         const Eigen::MatrixXi &F,
                                         Eigen::MatrixXd &uv,
                                         Eigen::VectorXi &soft_b_p,
-                                        Eigen::MatrixXd &soft_bc_p);
+                                        Eigen::MatrixXd &soft_bc_p,
+                                        igl::SLIMData::IterationStats &stats);
     IGL_INLINE void update_weights_and_closest_rotations( igl::SLIMData& s,
                                                           const Eigen::MatrixXd &V,
                                                           const Eigen::MatrixXi &F,
@@ -75,6 +75,7 @@ namespace igl
     IGL_INLINE void compute_jacobians(igl::SLIMData& s, const Eigen::MatrixXd &uv);
     IGL_INLINE void build_linear_system(igl::SLIMData& s, Eigen::SparseMatrix<double> &L);
     IGL_INLINE void pre_calc(igl::SLIMData& s);
+    IGL_INLINE void signed_measures(const Eigen::MatrixXi &F, const Eigen::MatrixXd &uv, Eigen::VectorXd &S);
 
     // Implementation
     IGL_INLINE void compute_surface_gradient_matrix(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F,
@@ -396,43 +397,118 @@ namespace igl
                                         const Eigen::MatrixXi &F,
                                         Eigen::MatrixXd &uv,
                                         Eigen::VectorXi &soft_b_p,
-                                        Eigen::MatrixXd &soft_bc_p)
+                                        Eigen::MatrixXd &soft_bc_p,
+                                        igl::SLIMData::IterationStats &stats)
     {
       using namespace Eigen;
 
+      igl::Timer t;
+      t.start();
       Eigen::SparseMatrix<double> L;
       build_linear_system(s,L);
+      stats.assembly_time = t.getElapsedTimeInSec();
+
+      // seems like CG performs much worse for 2D and way better for 3D
+      igl::SLIMData::SLIM_SOLVER solver_type = s.solver_type;
+      if (solver_type == igl::SLIMData::SLIM_SOLVER_DEFAULT)
+      {
+#ifdef CHOLMOD
+        solver_type = igl::SLIMData::SLIM_SOLVER_LDLT;
+#else
+        solver_type = s.dim == 2 ?
+          igl::SLIMData::SLIM_SOLVER_LDLT : igl::SLIMData::SLIM_SOLVER_CG;
+#endif
+      }
+
+      // The sparsity pattern of L is the same at every iteration: only
+      // analyze it once per solver
+      t.start();
+      if (s.analyzed_solver != solver_type)
+      {
+        switch (solver_type)
+        {
+          case igl::SLIMData::SLIM_SOLVER_CG:
+            s.cg.analyzePattern(L);
+            break;
+          case igl::SLIMData::SLIM_SOLVER_CG_ICHOL:
+            s.cg_ichol.analyzePattern(L);
+            break;
+          default:
+#ifdef CHOLMOD
+            s.cholmod_ldlt.analyzePattern(L);
+#else
+            s.ldlt.analyzePattern(L);
+#endif
+            break;
+        }
+        s.analyzed_solver = solver_type;
+      }
 
-      igl::Timer t;
-      
-      //t.start();
       // solve
       Eigen::VectorXd Uc;
-#ifndef CHOLMOD
-      if (s.dim == 2)
+      bool direct = solver_type == igl::SLIMData::SLIM_SOLVER_LDLT;
+      if (!direct)
       {
-        SimplicialLDLT<Eigen::SparseMatrix<double> > solver;
-        Uc = solver.compute(L).solve(s.rhs);
-      }
-      else
-      { // seems like CG performs much worse for 2D and way better for 3D
+        // warm start from current iterate
         Eigen::VectorXd guess(uv.rows() * s.dim);
         for (int i = 0; i < s.v_num; i++) for (int j = 0; j < s.dim; j++) guess(uv.rows() * j + i) = uv(i, j); // flatten vector
-        ConjugateGradient<Eigen::SparseMatrix<double>, Lower | Upper> cg;
-        cg.setTolerance(1e-8);
-        cg.compute(L);
-        Uc = cg.solveWithGuess(s.rhs, guess);
+        if (solver_type == igl::SLIMData::SLIM_SOLVER_CG_ICHOL)
+        {
+          s.cg_ichol.setTolerance(s.cg_tolerance);
+          s.cg_ichol.factorize(L);
+          stats.factorization_time = t.getElapsedTimeInSec();
+          t.start();
+          if (s.cg_ichol.info() == Eigen::Success)
+          {
+            Uc = s.cg_ichol.solveWithGuess(s.rhs, guess);
+          }
+          stats.cg_iterations = s.cg_ichol.iterations();
+          stats.cg_error = s.cg_ichol.error();
+          direct = s.cg_ichol.info() != Eigen::Success;
+        }
+        else
+        {
+          s.cg.setTolerance(s.cg_tolerance);
+          s.cg.factorize(L);
+          stats.factorization_time = t.getElapsedTimeInSec();
+          t.start();
+          Uc = s.cg.solveWithGuess(s.rhs, guess);
+          stats.cg_iterations = s.cg.iterations();
+          stats.cg_error = s.cg.error();
+          direct = s.cg.info() != Eigen::Success;
+        }
+        stats.solve_time = t.getElapsedTimeInSec();
+        if (direct)
+        {
+          // Preconditioner or CG failed: fall back to a direct solve
+          t.start();
+        }
       }
+      if (direct)
+      {
+#ifdef CHOLMOD
+        if (solver_type != igl::SLIMData::SLIM_SOLVER_LDLT)
+        {
+          s.cholmod_ldlt.analyzePattern(L);
+        }
+        s.cholmod_ldlt.factorize(L);
+        stats.factorization_time = t.getElapsedTimeInSec();
+        t.start();
+        Uc = s.cholmod_ldlt.solve(s.rhs);
 #else
-        CholmodSimplicialLDLT<Eigen::SparseMatrix<double> > solver;
-        Uc = solver.compute(L).solve(s.rhs);
+        if (solver_type != igl::SLIMData::SLIM_SOLVER_LDLT)
+        {
+          s.ldlt.analyzePattern(L);
+        }
+        s.ldlt.factorize(L);
+        stats.factorization_time = t.getElapsedTimeInSec();
+        t.start();
+        Uc = s.ldlt.solve(s.rhs);
 #endif
+        stats.solve_time = t.getElapsedTimeInSec();
+      }
       for (int i = 0; i < s.dim; i++)
         uv.col(i) = Uc.block(i * s.v_n, 0, s.v_n, 1);
-
-      // t.stop();
-      // std::cerr << "solve: " << t.getElapsedTime() << std::endl;
-
     }
 
 
@@ -571,6 +647,19 @@ namespace igl
       }
     }
 
+    IGL_INLINE void signed_measures(const Eigen::MatrixXi &F, const Eigen::MatrixXd &uv, Eigen::VectorXd &S)
+    {
+      if (F.cols() == 3)
+      {
+        // signed for 2D positions
+        igl::doublearea(uv, F, S);
+      }
+      else
+      {
+        igl::volume(uv, F, S);
+      }
+    }
+
     IGL_INLINE double compute_energy(igl::SLIMData& s, Eigen::MatrixXd &V_new)
     {
       compute_jacobians(s,V_new);
@@ -930,6 +1019,9 @@ IGL_INLINE void igl::slim_precompute(
 
   assert (F.cols() == 3 || F.cols() == 4);
 
+  data.analyzed_solver = -1;
+  data.stats.clear();
+  data.anderson_initialized = false;
   igl::slim::pre_calc(data);
   data.energy = igl::slim::compute_energy(data,data.V_o) / data.mesh_area;
 }
@@ -938,20 +1030,65 @@ IGL_INLINE Eigen::MatrixXd igl::slim_solve(SLIMData &data, int iter_num)
 {
   for (int i = 0; i < iter_num; i++)
   {
+    igl::SLIMData::IterationStats stats;
     Eigen::MatrixXd dest_res;
     dest_res = data.V_o;
+    const Eigen::MatrixXd V_prev = data.V_o;
 
     // Solve Weighted Proxy
     igl::slim::update_weights_and_closest_rotations(data,data.V, data.F, dest_res);
-    igl::slim::solve_weighted_arap(data,data.V, data.F, dest_res, data.b, data.bc);
-
-    double old_energy = data.energy;
+    igl::slim::solve_weighted_arap(data,data.V, data.F, dest_res, data.b, data.bc, stats);
 
     std::function<double(Eigen::MatrixXd &)> compute_energy = [&](
         Eigen::MatrixXd &aaa) { return igl::slim::compute_energy(data,aaa); };
 
+    igl::Timer t;
+    t.start();
     data.energy = igl::flip_avoiding_line_search(data.F, data.V_o, dest_res, compute_energy,
                                                  data.energy * data.mesh_area) / data.mesh_area;
+    stats.line_search_time = t.getElapsedTimeInSec();
+    if (data.anderson_m > 0)
+    {
+      // data.V_o = G(V_prev) is the plain iterate
+      if (!data.anderson_initialized)
+      {
+        data.anderson.init(data.anderson_m, Eigen::Map<const Eigen::VectorXd>(V_prev.data(), V_prev.size()));
+        data.anderson_initialized = true;
+      }
+      const Eigen::VectorXd x = data.anderson.compute(
+          Eigen::Map<const Eigen::VectorXd>(data.V_o.data(), data.V_o.size()));
+      stats.residual = data.anderson.residual();
+      Eigen::MatrixXd V_acc = Eigen::Map<const Eigen::MatrixXd>(x.data(), data.V_o.rows(), data.V_o.cols());
+      // the first iterate after (re)starting is the plain one
+      const bool candidate = V_acc != data.V_o;
+      bool accept = candidate;
+      if (accept)
+      {
+        // no element may flip with respect to the plain iterate
+        Eigen::VectorXd S, S_acc;
+        igl::slim::signed_measures(data.F, data.V_o, S);
+        igl::slim::signed_measures(data.F, V_acc, S_acc);
+        accept = (S.array() * S_acc.array() > 0).all();
+      }
+      double energy_acc = 0;
+      if (accept)
+      {
+        energy_acc = igl::slim::compute_energy(data, V_acc) / data.mesh_area;
+        accept = energy_acc < data.energy;
+      }
+      if (accept)
+      {
+        data.V_o = V_acc;
+        data.energy = energy_acc;
+        stats.accelerated = true;
+      }
+      else if (candidate)
+      {
+        data.anderson.restart(Eigen::Map<const Eigen::VectorXd>(data.V_o.data(), data.V_o.size()));
+      }
+    }
+    stats.energy = data.energy;
+    data.stats.push_back(stats);
   }
   return data.V_o;
 }
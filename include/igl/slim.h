@@ -9,8 +9,13 @@
 #define SLIM_H
 
 #include "igl_inline.h"
+#include "AndersonAcceleration.h"
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
+#include <vector>
+#ifdef CHOLMOD
+#include <Eigen/CholmodSupport>
+#endif
 
 // This option makes the iterations faster (all except the first) by caching the 
 // sparsity pattern of the matrix involved in the assembly. It should be on if you plan to do many iterations, off if you have to change the matrix structure at every iteration.
@@ -49,6 +54,41 @@ struct SLIMData
   double exp_factor; // used for exponential energies, ignored otherwise
   bool mesh_improvement_3d; // only supported for 3d
 
+  // Linear solver used for the global (weighted ARAP) step. The sparsity
+  // pattern of the system never changes, so direct solvers analyze it once
+  // and only refactor numerically, while iterative solvers are warm started
+  // from the current iterate.
+  enum SLIM_SOLVER
+  {
+    SLIM_SOLVER_DEFAULT, // SLIM_SOLVER_LDLT in 2D (and in 3D with CHOLMOD), SLIM_SOLVER_CG in 3D
+    SLIM_SOLVER_LDLT, // sparse LDLT
+    SLIM_SOLVER_CG, // conjugate gradient, diagonal preconditioner
+    SLIM_SOLVER_CG_ICHOL // conjugate gradient, incomplete Cholesky preconditioner
+  };
+  SLIM_SOLVER solver_type = SLIM_SOLVER_DEFAULT;
+  double cg_tolerance = 1e-8; // relative residual tolerance of CG solvers
+
+  // If > 0, accelerate the local/global iterations with Anderson acceleration
+  // using this window size (see igl::AndersonAcceleration). Accelerated
+  // iterates are only accepted if they flip no element and decrease the
+  // energy.
+  int anderson_m = 0;
+
+  // Timings (in seconds) and solver statistics of one slim_solve iteration
+  struct IterationStats
+  {
+    double assembly_time = 0; // building the linear system
+    double factorization_time = 0; // numeric factorization or preconditioner
+    double solve_time = 0; // back-substitution or CG iterations
+    double line_search_time = 0; // flip avoiding line search
+    int cg_iterations = 0; // 0 for direct solvers
+    double cg_error = 0; // estimated relative residual of CG solvers
+    double energy = 0; // energy after the iteration
+    bool accelerated = false; // whether the Anderson accelerated iterate was accepted
+    double residual = 0; // fixed-point residual |G(V_o)-V_o| (only with anderson_m > 0)
+  };
+  std::vector<IterationStats> stats; // one entry per iteration of slim_solve
+
   // Output
   Eigen::MatrixXd V_o; // #V by dim list of mesh vertex positions (dim = 2 for parametrization, 3 otherwise)
   double energy; // objective value
@@ -56,6 +96,8 @@ struct SLIMData
   // INTERNAL
   Eigen::VectorXd M;
   double mesh_area;
+  AndersonAcceleration<double> anderson;
+  bool anderson_initialized;
   double avg_edge_length;
   int v_num;
   int f_num;
@@ -73,6 +115,18 @@ struct SLIMData
   bool has_pre_calc = false;
   int dim;
 
+  // Cached inner solvers (see solver_type; with CHOLMOD, direct solves use
+  // cholmod_ldlt instead of ldlt)
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > ldlt;
+#ifdef CHOLMOD
+  Eigen::CholmodSimplicialLDLT<Eigen::SparseMatrix<double> > cholmod_ldlt;
+#endif
+  Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower | Eigen::Upper> cg;
+  Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower | Eigen::Upper,
+    Eigen::IncompleteCholesky<double> > cg_ichol;
+  // Solver (SLIM_SOLVER) whose pattern has been analyzed, -1 if none
+  int analyzed_solver = -1;
+
   #ifdef SLIM_CACHED
   Eigen::SparseMatrix<double> A;
   Eigen::VectorXi A_data;
@@ -102,6 +156,7 @@ IGL_INLINE void slim_precompute(
 // Run iter_num iterations of SLIM
 // Outputs:
 //    V_o (in SLIMData): #V by dim list of mesh vertex positions
+//    stats (in SLIMData): appended with one entry per iteration
 IGL_INLINE Eigen::MatrixXd slim_solve(SLIMData& data, int iter_num);
 
 } // END NAMESPACE
@@ -0,0 +1,230 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "weld_and_compact.h"
+#include "parallel_for.h"
+#include "UnionFind.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedSV,
+  typename DerivedSF,
+  typename DerivedSVI,
+  typename DerivedSVJ>
+IGL_INLINE void igl::weld_and_compact(
+  const Eigen::MatrixBase<DerivedV>& V,
+  const Eigen::MatrixBase<DerivedF>& F,
+  const double epsilon,
+  Eigen::PlainObjectBase<DerivedSV>& SV,
+  Eigen::PlainObjectBase<DerivedSF>& SF,
+  Eigen::PlainObjectBase<DerivedSVI>& SVI,
+  Eigen::PlainObjectBase<DerivedSVJ>& SVJ)
+{
+  typedef std::uint64_t Key;
+  const int n = V.rows();
+  const int dim = V.cols();
+  const bool exact = !(epsilon > 0);
+  // Hash of a grid cell (or of the exact coordinates if epsilon <= 0)
+  const auto mix = [](Key h, const Key c)->Key
+  {
+    h ^= c + 0x9e3779b97f4a7c15ull + (h<<6) + (h>>2);
+    return h;
+  };
+  // Cell index along dimension d, clamped so that the conversion is defined
+  // for tiny epsilon or large coordinates (far away cells then collapse onto
+  // the clamped one, which only costs extra comparisons)
+  const auto cell = [&V,&epsilon](const int i, const int d)->long long
+  {
+    const double max_cell = 4611686018427387904.0;
+    const double c = std::floor(double(V(i,d))/epsilon);
+    if(c != c)
+    {
+      return 0;
+    }
+    return (long long)std::max(-max_cell,std::min(max_cell,c));
+  };
+  const auto exact_key = [&V,&dim,&mix](const int i)->Key
+  {
+    Key h = 0;
+    for(int d = 0;d<dim;d++)
+    {
+      // +0.0 so that -0.0 and 0.0 hash the same
+      const double x = double(V(i,d))+0.0;
+      Key c;
+      std::memcpy(&c,&x,sizeof(double));
+      h = mix(h,c);
+    }
+    return h;
+  };
+
+  // Sorted list of (key,index) pairs. Sort chunks in parallel, then merge
+  // pairs of neighboring chunks in parallel.
+  std::vector<std::pair<Key,int> > K(n);
+  parallel_for(n,[&](const int i)
+  {
+    Key h = 0;
+    if(exact)
+    {
+      h = exact_key(i);
+    }else
+    {
+      for(int d = 0;d<dim;d++)
+      {
+        h = mix(h,(Key)cell(i,d));
+      }
+    }
+    K[i] = std::make_pair(h,i);
+  },10000);
+  {
+    const size_t sthc = std::thread::hardware_concurrency();
+    const size_t num_chunks =
+      std::max<size_t>(1,std::min<size_t>(sthc==0?8:sthc,n/10000));
+    std::vector<size_t> bounds(num_chunks+1);
+    for(size_t c = 0;c<=num_chunks;c++)
+    {
+      bounds[c] = (c*n)/num_chunks;
+    }
+    parallel_for(num_chunks,[&](const size_t c)
+    {
+      std::sort(K.begin()+bounds[c],K.begin()+bounds[c+1]);
+    },2);
+    for(size_t width = 1;width<num_chunks;width*=2)
+    {
+      const size_t num_merges = (num_chunks+2*width-1)/(2*width);
+      parallel_for(num_merges,[&](const size_t m)
+      {
+        const size_t c = 2*width*m;
+        const size_t mid = std::min(c+width,num_chunks);
+        const size_t end = std::min(c+2*width,num_chunks);
+        std::inplace_merge(
+          K.begin()+bounds[c],K.begin()+bounds[mid],K.begin()+bounds[end]);
+      },2);
+    }
+  }
+
+  // Merge each vertex with all close, lower-index vertices in its own and
+  // neighboring cells
+  UnionFind uf(n);
+  const double eps2 = epsilon*epsilon;
+  const auto close = [&](const int i, const int j)->bool
+  {
+    if(exact)
+    {
+      return V.row(i) == V.row(j);
+    }
+    return (V.row(i)-V.row(j)).squaredNorm() <= eps2;
+  };
+  const auto merge_with_cell = [&](const int i, const Key h)
+  {
+    const auto range = std::equal_range(
+      K.begin(),K.end(),std::make_pair(h,0),
+      [](const std::pair<Key,int> & a, const std::pair<Key,int> & b)
+      {
+        return a.first < b.first;
+      });
+    for(auto it = range.first;it != range.second;it++)
+    {
+      const int j = it->second;
+      if(j < i && close(i,j))
+      {
+        uf.unite(i,j);
+      }
+    }
+  };
+  int num_neighbors = 1;
+  for(int d = 0;d<dim;d++)
+  {
+    num_neighbors *= 3;
+  }
+  parallel_for(n,[&](const int i)
+  {
+    if(exact)
+    {
+      merge_with_cell(i,exact_key(i));
+      return;
+    }
+    // Loop over all 3^dim neighboring cells (including i's own)
+    for(int o = 0;o<num_neighbors;o++)
+    {
+      Key h = 0;
+      int oo = o;
+      for(int d = 0;d<dim;d++)
+      {
+        h = mix(h,(Key)(cell(i,d)+(oo%3)-1));
+        oo /= 3;
+      }
+      merge_with_cell(i,h);
+    }
+  },1000);
+  // Cluster ids ordered by each cluster's smallest vertex
+  Eigen::VectorXi C;
+  uf.labels(C);
+  const int num_clusters = n == 0 ? 0 : C.maxCoeff()+1;
+
+  // Mark clusters referenced by F
+  std::unique_ptr<std::atomic<bool>[]> referenced(
+    new std::atomic<bool>[num_clusters]);
+  parallel_for(num_clusters,[&referenced](const int c)
+  {
+    referenced[c].store(false,std::memory_order_relaxed);
+  },10000);
+  parallel_for(F.rows(),[&](const int f)
+  {
+    for(int c = 0;c<F.cols();c++)
+    {
+      if(F(f,c) >= 0)
+      {
+        referenced[C(F(f,c))].store(true,std::memory_order_relaxed);
+      }
+    }
+  },10000);
+  // Compact: the first vertex of each referenced cluster represents it
+  std::vector<int> I(num_clusters,-1);
+  std::vector<int> vSVI;
+  for(int i = 0;i<n;i++)
+  {
+    const int c = C(i);
+    if(referenced[c].load(std::memory_order_relaxed) && I[c] < 0)
+    {
+      I[c] = vSVI.size();
+      vSVI.push_back(i);
+    }
+  }
+  SVI.resize(vSVI.size(),1);
+  SV.resize(vSVI.size(),dim);
+  parallel_for(vSVI.size(),[&](const int s)
+  {
+    SVI(s) = vSVI[s];
+    SV.row(s) = V.row(vSVI[s]).template cast<typename DerivedSV::Scalar>();
+  },10000);
+  SVJ.resize(n,1);
+  parallel_for(n,[&](const int i){ SVJ(i) = I[C(i)]; },10000);
+  SF.resize(F.rows(),F.cols());
+  parallel_for(F.rows(),[&](const int f)
+  {
+    for(int c = 0;c<F.cols();c++)
+    {
+      SF(f,c) = F(f,c) >= 0 ? SVJ(F(f,c)) : F(f,c);
+    }
+  },10000);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::weld_and_compact<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, double, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::weld_and_compact<Eigen::Matrix<float, -1, 3, 1, -1, 3>, Eigen::Matrix<int, -1, 3, 1, -1, 3>, Eigen::Matrix<float, -1, 3, 1, -1, 3>, Eigen::Matrix<int, -1, 3, 1, -1, 3>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, 3, 1, -1, 3> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 3, 1, -1, 3> > const&, double, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, 3, 1, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 1, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+#endif
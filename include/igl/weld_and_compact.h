@@ -0,0 +1,62 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2026 agent
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_WELD_AND_COMPACT_H
+#define IGL_WELD_AND_COMPACT_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // WELD_AND_COMPACT Merge vertices closer than a tolerance and remove
+  // vertices not referenced by any simplex, in a single pass. This is the
+  // combination of remove_duplicate_vertices and remove_unreferenced needed to
+  // turn a triangle soup (e.g., from an .stl file) into an indexed mesh.
+  //
+  // Vertices are hashed into a uniform grid with cells of size epsilon and
+  // compared against all vertices in neighboring cells, so that points
+  // closer than epsilon are always merged, even across cell boundaries.
+  // Merging is transitive (chains of close points end up in the same
+  // cluster). The hashing, neighbor tests and merging (see igl::UnionFind)
+  // run in parallel, yet the output does not depend on the number of
+  // threads: each cluster is represented by its vertex with the smallest
+  // index and output vertices are ordered by that index.
+  //
+  // Inputs:
+  //   V  #V by dim list of vertex positions
+  //   F  #F by ss list of simplex indices into V
+  //   epsilon  Euclidean distance tolerance. If epsilon <= 0 then only
+  //     exactly equal vertices are merged.
+  // Outputs:
+  //   SV  #SV by dim list of welded, referenced vertex positions
+  //   SF  #F by ss list of simplex indices into SV
+  //   SVI  #SV by 1 list of indices so SV = V(SVI,:)
+  //   SVJ  #V by 1 list of indices so that SF = SVJ(F), and vertices not
+  //     referenced by F are assigned -1
+  //
+  // See also: remove_duplicate_vertices, remove_unreferenced
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedSV,
+    typename DerivedSF,
+    typename DerivedSVI,
+    typename DerivedSVJ>
+  IGL_INLINE void weld_and_compact(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const double epsilon,
+    Eigen::PlainObjectBase<DerivedSV>& SV,
+    Eigen::PlainObjectBase<DerivedSF>& SF,
+    Eigen::PlainObjectBase<DerivedSVI>& SVI,
+    Eigen::PlainObjectBase<DerivedSVJ>& SVJ);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "weld_and_compact.cpp"
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+#include <igl/lobpcg.h>
+#include <igl/cotmatrix.h>
+#include <igl/massmatrix.h>
+#include <igl/opengl/glfw/Viewer.h>
+#include <igl/parula.h>
+#include <igl/read_triangle_mesh.h>
+#include <Eigen/Sparse>
+#include <iostream>
+#include "tutorial_shared_path.h"
+
+Eigen::MatrixXd V,U;
+Eigen::MatrixXi F;
+int c=1;
+int main(int argc, char * argv[])
+{
+  using namespace Eigen;
+  using namespace std;
+  using namespace igl;
+  VectorXd S;
+  if(!read_triangle_mesh(
+     argc>1?argv[1]: TUTORIAL_SHARED_PATH "/bumpy.off",V,F))
+  {
+    cout<<"failed to load mesh"<<endl;
+  }
+  SparseMatrix<double> L,M;
+  cotmatrix(V,F,L);
+  L = (-L).eval();
+  massmatrix(V,F,MASSMATRIX_TYPE_DEFAULT,M);
+  // Many of the smallest eigen pairs at once (e.g., for spectral shape
+  // descriptors): blocked iterations preconditioned by one factorization
+  const int k = 50;
+  if(!lobpcg(L,M,k,-1e-8,U,S))
+  {
+    cout<<"failed."<<endl;
+  }
+  cout<<"eigen values: ["<<S(0)<<","<<S(k-1)<<"]"<<endl;
+
+  igl::opengl::glfw::Viewer viewer;
+  viewer.callback_key_down = [&](igl::opengl::glfw::Viewer & viewer,unsigned char key,int)->bool
+  {
+    switch(key)
+    {
+      default:
+        return false;
+      case ' ':
+      {
+        // Skip the constant mode (eigen value 0)
+        Eigen::MatrixXd C;
+        igl::parula(U.col(c).eval(),true,C);
+        cout<<"mode "<<c<<": "<<S(c)<<endl;
+        c = c%(k-1)+1;
+        viewer.data().set_colors(C);
+        return true;
+      }
+    }
+  };
+  viewer.data().set_mesh(V,F);
+  viewer.callback_key_down(viewer,' ',0);
+  viewer.data().show_lines = false;
+  std::cout<<
+R"(
+  [space] Cycle through eigen modes
+)";
+  viewer.launch();
+}
@@ -0,0 +1,94 @@
+#include <igl/bbw.h>
+#include <igl/boundary_facets.h>
+#include <igl/colon.h>
+#include <igl/jet.h>
+#include <igl/normalize_row_sums.h>
+#include <igl/readOBJ.h>
+#include <igl/setdiff.h>
+#include <igl/unique.h>
+#include <igl/Timer.h>
+#include <igl/opengl/glfw/Viewer.h>
+#include <Eigen/Core>
+#include <iostream>
+#include "tutorial_shared_path.h"
+
+Eigen::MatrixXd V,W;
+Eigen::MatrixXi F;
+Eigen::VectorXi b;
+int selected = 0;
+
+void set_color(igl::opengl::glfw::Viewer &viewer)
+{
+  Eigen::MatrixXd C;
+  igl::jet(W.col(selected).eval(),true,C);
+  viewer.data().set_colors(C);
+  viewer.data().set_points(V.row(b(selected)),Eigen::RowVector3d(1,1,1));
+}
+
+int main(int argc, char *argv[])
+{
+  using namespace Eigen;
+  using namespace std;
+  igl::readOBJ(TUTORIAL_SHARED_PATH "/bump-domain.obj",V,F);
+  // 2D mesh
+  V = V.leftCols(2).eval();
+
+  // Many point handles spread over the interior
+  MatrixXi E;
+  igl::boundary_facets(F,E);
+  VectorXi bnd,IA,IC,all,in;
+  igl::unique(E,bnd,IA,IC);
+  igl::colon<int>(0,V.rows()-1,all);
+  igl::setdiff(all,bnd,in,IA);
+  const int m = argc>1 ? atoi(argv[1]) : 32;
+  b.resize(m);
+  for(int k = 0;k<m;k++)
+  {
+    b(k) = in((long(k)*in.size())/m);
+  }
+  // Each handle has weight 1 at itself and 0 at the other handles
+  const MatrixXd bc = MatrixXd::Identity(m,m);
+
+  // All handles share one factorization of the bilaplacian; changes of the
+  // active bound constraints are handled with Schur complements
+  igl::BBWData bbw_data;
+  igl::Timer timer;
+  timer.start();
+  if(!igl::bbw(V,F,b,bc,bbw_data,W))
+  {
+    return EXIT_FAILURE;
+  }
+  cout<<"Computed "<<m<<" weight functions in "<<
+    timer.getElapsedTimeInSec()<<" secs"<<endl;
+  // Normalize weights to sum to one
+  igl::normalize_row_sums(W,W);
+
+  igl::opengl::glfw::Viewer viewer;
+  viewer.data().set_mesh(V,F);
+  viewer.data().show_lines = false;
+  viewer.data().point_size = 10;
+  set_color(viewer);
+  viewer.callback_key_down =
+    [](igl::opengl::glfw::Viewer & viewer,unsigned char key,int)->bool
+  {
+    switch(key)
+    {
+      case '.':
+        selected = (selected+1)%W.cols();
+        break;
+      case ',':
+        selected = (selected+W.cols()-1)%W.cols();
+        break;
+      default:
+        return false;
+    }
+    set_color(viewer);
+    return true;
+  };
+  std::cout<<
+R"(
+  .  Show next weight function
+  ,  Show previous weight function
+)";
+  return viewer.launch();
+}
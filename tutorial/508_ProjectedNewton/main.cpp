@@ -0,0 +1,87 @@
+#include <igl/boundary_loop.h>
+#include <igl/harmonic.h>
+#include <igl/map_vertices_to_circle.h>
+#include <igl/projected_newton.h>
+#include <igl/readOFF.h>
+#include <igl/opengl/glfw/Viewer.h>
+#include <iostream>
+
+#include "tutorial_shared_path.h"
+
+Eigen::MatrixXd V;
+Eigen::MatrixXi F;
+Eigen::MatrixXd V_uv;
+igl::ProjectedNewtonData pn_data;
+
+bool show_uv = false;
+
+bool key_down(igl::opengl::glfw::Viewer& viewer, unsigned char key, int modifier)
+{
+  if (key == '1')
+    show_uv = false;
+  else if (key == '2')
+    show_uv = true;
+
+  if (key == ' ')
+  {
+    // One Newton step with per-element projected Hessians
+    V_uv = igl::projected_newton_solve(pn_data,1);
+    std::cout<<"symmetric Dirichlet energy: "<<pn_data.energy<<std::endl;
+  }
+
+  if (show_uv)
+  {
+    viewer.data().set_mesh(V_uv,F);
+    viewer.core.align_camera_center(V_uv,F);
+  }
+  else
+  {
+    viewer.data().set_mesh(V,F);
+    viewer.core.align_camera_center(V,F);
+  }
+  // Scale UV to make the texture more clear
+  viewer.data().set_uv(V_uv*20);
+
+  viewer.data().compute_normals();
+
+  return false;
+}
+
+int main(int argc, char *argv[])
+{
+  using namespace std;
+  // Load a mesh in OFF format
+  igl::readOFF(TUTORIAL_SHARED_PATH "/camelhead.off", V, F);
+
+  // Compute a map without flipped triangles to start from (harmonic
+  // parametrization)
+  Eigen::VectorXi bnd;
+  igl::boundary_loop(F,bnd);
+  Eigen::MatrixXd bnd_uv;
+  igl::map_vertices_to_circle(V,bnd,bnd_uv);
+  igl::harmonic(V,F,bnd,bnd_uv,1,V_uv);
+
+  // Minimize the symmetric Dirichlet energy with a free boundary
+  Eigen::VectorXi b;
+  Eigen::MatrixXd bc;
+  igl::projected_newton_precompute(
+    V,F,V_uv,igl::ProjectedNewtonData::SYMMETRIC_DIRICHLET,b,bc,pn_data);
+  cout<<"symmetric Dirichlet energy: "<<pn_data.energy<<endl;
+
+  // Plot the mesh
+  igl::opengl::glfw::Viewer viewer;
+  viewer.data().set_mesh(V, F);
+  viewer.data().set_uv(V_uv*20);
+  viewer.callback_key_down = &key_down;
+
+  // Disable wireframe
+  viewer.data().show_lines = false;
+
+  // Draw checkerboard texture
+  viewer.data().show_texture = true;
+
+  cout<<"Press [space] to do one projected Newton iteration."<<endl;
+  cout<<"Press [1] to show the 3D mesh, [2] to show the parametrization."<<endl;
+  // Launch the viewer
+  viewer.launch();
+}
@@ -0,0 +1,78 @@
+#include <igl/edge_lengths.h>
+#include <igl/read_triangle_mesh.h>
+#include <igl/weld_and_compact.h>
+#include <igl/opengl/glfw/Viewer.h>
+#include <Eigen/Core>
+#include <iostream>
+#include "tutorial_shared_path.h"
+
+Eigen::MatrixXd S,SV;
+Eigen::MatrixXi FS,SF;
+bool show_welded = false;
+
+void update(igl::opengl::glfw::Viewer & viewer)
+{
+  viewer.data().clear();
+  if(show_welded)
+  {
+    // Shared vertices: normals are averaged over neighboring faces
+    viewer.data().set_mesh(SV,SF);
+  }else
+  {
+    // Every corner has its own vertex: faceted look
+    viewer.data().set_mesh(S,FS);
+  }
+  viewer.data().set_face_based(false);
+}
+
+int main(int argc, char *argv[])
+{
+  using namespace Eigen;
+  using namespace std;
+  MatrixXd V;
+  MatrixXi F;
+  igl::read_triangle_mesh(TUTORIAL_SHARED_PATH "/bunny.off",V,F);
+  MatrixXd L;
+  igl::edge_lengths(V,F,L);
+  const double h = L.minCoeff();
+
+  // Triangle soup (e.g., as read from an STL file): every corner gets its
+  // own copy of its vertex, slightly perturbed as if by rounding
+  const int m = F.rows();
+  S.resize(3*m,3);
+  FS.resize(m,3);
+  for(int f = 0;f<m;f++)
+  {
+    for(int c = 0;c<3;c++)
+    {
+      S.row(3*f+c) =
+        V.row(F(f,c)) + 1e-4*h*RowVector3d::Random();
+      FS(f,c) = 3*f+c;
+    }
+  }
+
+  // Merge vertices closer than a small fraction of the shortest edge and
+  // drop unreferenced vertices, in one pass
+  VectorXi SVI,SVJ;
+  igl::weld_and_compact(S,FS,1e-2*h,SV,SF,SVI,SVJ);
+  cout<<"Welded "<<S.rows()<<" soup vertices into "<<SV.rows()<<
+    " vertices ("<<V.rows()<<" in the original mesh)"<<endl;
+
+  igl::opengl::glfw::Viewer viewer;
+  viewer.callback_key_down =
+    [](igl::opengl::glfw::Viewer & viewer,unsigned char key,int)->bool
+  {
+    switch(key)
+    {
+      case ' ':
+        show_welded = !show_welded;
+        update(viewer);
+        return true;
+      default:
+        return false;
+    }
+  };
+  update(viewer);
+  cout<<"Press [space] to toggle between the soup and the welded mesh."<<endl;
+  return viewer.launch();
+}
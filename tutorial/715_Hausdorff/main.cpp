@@ -0,0 +1,71 @@
+#include <igl/hausdorff.h>
+#include <igl/jet.h>
+#include <igl/per_vertex_normals.h>
+#include <igl/point_mesh_squared_distance.h>
+#include <igl/read_triangle_mesh.h>
+#include <igl/opengl/glfw/Viewer.h>
+#include <Eigen/Core>
+#include <cmath>
+#include <iostream>
+#include "tutorial_shared_path.h"
+
+int main(int argc, char *argv[])
+{
+  using namespace Eigen;
+  using namespace std;
+  MatrixXd VA;
+  MatrixXi FA;
+  igl::read_triangle_mesh(TUTORIAL_SHARED_PATH "/bunny.off",VA,FA);
+  const double bbd =
+    (VA.colwise().maxCoeff()-VA.colwise().minCoeff()).norm();
+  // B: every other vertex of A pushed along its normal
+  MatrixXd N;
+  igl::per_vertex_normals(VA,FA,N);
+  MatrixXd VB = VA;
+  for(int i = 0;i<VB.rows();i+=2)
+  {
+    VB.row(i) += 0.01*bbd*sin(0.37*i)*N.row(i);
+  }
+  const MatrixXi FB = FA;
+
+  // Hausdorff distance accounting for all points of both surfaces, certified
+  // up to a tolerance
+  const double max_error = 1e-4*bbd;
+  double d,error;
+  if(!igl::hausdorff(VA,FA,VB,FB,max_error,d,error))
+  {
+    cout<<"Warning: subdivision depth reached before the tolerance"<<endl;
+  }
+  cout<<"Hausdorff distance in ["<<d<<","<<d+error<<"]"<<endl;
+  // Compare to the distances of only the vertices
+  double d_vertices;
+  igl::hausdorff(VA,FA,VB,FB,d_vertices);
+  cout<<"Vertices only:        "<<d_vertices<<endl;
+
+  // The two triangulations of a non-planar quad share all vertices, yet are
+  // at a positive distance
+  MatrixXd VQ(4,3);
+  VQ<<0,0,0, 1,0,0, 1,1,0, 0,1,1;
+  MatrixXi FQA(2,3),FQB(2,3);
+  FQA<<0,1,2, 0,2,3;
+  FQB<<0,1,3, 1,2,3;
+  double dq,errorq,dq_vertices;
+  igl::hausdorff(VQ,FQA,VQ,FQB,1e-6,dq,errorq);
+  igl::hausdorff(VQ,FQA,VQ,FQB,dq_vertices);
+  cout<<"Quad: Hausdorff distance in ["<<dq<<","<<dq+errorq<<
+    "], vertices only: "<<dq_vertices<<endl;
+
+  // Color B by the distance of its vertices to A, relative to the Hausdorff
+  // distance
+  VectorXd sqrD;
+  VectorXi I;
+  MatrixXd C,P;
+  igl::point_mesh_squared_distance(VB,VA,FA,sqrD,I,P);
+  igl::jet(VectorXd(sqrD.array().sqrt()),0,d+error,C);
+
+  igl::opengl::glfw::Viewer viewer;
+  viewer.data().set_mesh(VB,FB);
+  viewer.data().set_colors(C);
+  viewer.data().show_lines = false;
+  return viewer.launch();
+}